@@ -0,0 +1,89 @@
+// Counts heap allocations per DE generation for every mutation operator, and for every credit and reward of
+// the adaptive strategy. Generations allocate nothing once the buffers are sized, which the bench checks.
+// Build with `make bench`, then run ./allocations [dimension] [generations]
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include "coco.h"
+#include "differentialevolution.h"
+#include "params.h"
+#include "default_params.h"
+
+static unsigned long long allocations = 0;
+
+// Eigen allocates its buffers with malloc rather than operator new, so count at the malloc level (glibc)
+extern "C" {
+	void* __libc_malloc(std::size_t size);
+	void* __libc_calloc(std::size_t n, std::size_t size);
+	void* __libc_realloc(void* p, std::size_t size);
+
+	void* malloc(std::size_t const size){
+		allocations++;
+		return __libc_malloc(size);
+	}
+
+	void* calloc(std::size_t const n, std::size_t const size){
+		allocations++;
+		return __libc_calloc(n, size);
+	}
+
+	void* realloc(void* const p, std::size_t const size){
+		allocations++;
+		return __libc_realloc(p, size);
+	}
+}
+
+// Allocations per generation of a prepared DE after its buffers are sized: the difference between a run of
+// 1 + generations generations and a run of 1, which allocate the same local buffers
+static unsigned long long perGeneration(DifferentialEvolution& de, coco_problem_t* const problem, int const popSize,
+		int const generations){
+	de.run(coco_problem_get_evaluations(problem) + popSize); // Warm-up, sizes the buffers
+	unsigned long long const start = allocations;
+	de.run(coco_problem_get_evaluations(problem) + popSize);
+	unsigned long long const one = allocations - start;
+	de.run(coco_problem_get_evaluations(problem) + (1 + generations) * popSize);
+	unsigned long long const many = allocations - start - one;
+	return many > one ? (many - one + generations - 1) / generations : 0; // Rounded up
+}
+
+int main(int argc, char** argv){
+	int const dimension = argc > 1 ? std::atoi(argv[1]) : 40;
+	int const generations = argc > 2 ? std::atoi(argv[2]) : 50;
+	int const popSize = dimension * params::popsize_multiplier;
+	params::restart_on_convergence = false;
+	coco_set_log_level("error");
+
+	coco_suite_t* const suite = coco_suite("bbob", "instances: 1", "");
+	coco_problem_t* const problem = coco_suite_get_problem_by_function_dimension_instance(suite, 15, dimension, 1);
+	if (!problem){
+		std::cerr << "Dimension " << dimension << " is not part of the bbob suite" << std::endl;
+		return 1;
+	}
+
+	bool none = true;
+	auto const report = [&none](std::string const& id, unsigned long long const count){
+		std::cout << std::setw(5) << id << std::setw(12) << count << (count > 0 ? "  FAILED" : "") << std::endl;
+		none = none && count == 0;
+	};
+
+	std::cout << "D=" << dimension << " NP=" << popSize << " allocations per generation:" << std::endl;
+	for (std::string const m : {"RA1","TB1","TB2","TR1","TP1","BE1","BE2","RA2","R2D","NSD","TRI","TO1","TO2","PRX","RAN"}){
+		DifferentialEvolution de("bench", {"C", "PR", {{m}, {"B"}, "S", "FI", "EA", "WS", "AP"}});
+		de.prepare(problem, popSize);
+		report(m, perGeneration(de, problem, popSize, generations));
+		de.reset();
+	}
+
+	std::cout << "Adaptive strategy, per credit and reward:" << std::endl;
+	for (std::string const credit : {"DR","SD","FD","FS","FI","CO","PA"})
+	for (std::string const reward : {"AN","AA","EN","EA","ER","AR"}){
+		DifferentialEvolution de("bench", {"A", "PR", {{"RA1","TB1"}, {"B","E"}, "S", credit, reward, "WS", "AP"}});
+		de.prepare(problem, popSize);
+		report(credit + " " + reward, perGeneration(de, problem, popSize, generations));
+		de.reset();
+	}
+
+	coco_problem_free(problem);
+	coco_suite_free(suite);
+	return none ? 0 : 1;
+}
@@ -0,0 +1,87 @@
+// Measures the cost model that schedules campaign tasks (expectedCost in experiment.cc): the time per evaluation
+// and coordinate of every bbob function, and of the algorithm's own work per trial and coordinate, in ns.
+// Build with `make bench`, then run ./costs [dimension] [evaluations] > costs.txt and pass --costs costs.txt to experiment
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "coco.h"
+#include "differentialevolution.h"
+#include "params.h"
+#include "default_params.h"
+
+static int const REPETITIONS = 5; // The fastest repetition is kept, as the least disturbed by other processes
+
+// Time per evaluation of the problem in ns, over random points of the domain
+static double timeEvaluations(coco_problem_t* const problem, std::vector<double> const& X, int const evaluations){
+	int const D = coco_problem_get_dimension(problem), points = X.size() / D;
+	volatile double sink = 0; // Keeps the evaluations from being optimized away
+	double best = INFINITY;
+	for (int r = 0; r < REPETITIONS; r++){
+		auto const start = std::chrono::steady_clock::now();
+		for (int k = 0; k < evaluations; k++){
+			double y;
+			coco_evaluate_function(problem, &X[(k % points) * D], &y);
+			sink += y;
+		}
+		double const ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+		best = std::min(best, ns / evaluations);
+	}
+	return best;
+}
+
+int main(int argc, char** argv){
+	int const dimension = argc > 1 ? std::atoi(argv[1]) : 40;
+	int const evaluations = argc > 2 ? std::atoi(argv[2]) : 20000;
+	int const popSize = dimension * params::popsize_multiplier;
+	params::restart_on_convergence = false;
+	coco_set_log_level("error");
+	std::string const level = coco_set_simd_level("auto");
+
+	std::mt19937_64 engine(1);
+	std::uniform_real_distribution<double> unit(-5, 5);
+	std::vector<double> X(dimension * 100);
+	for (double& xi : X)
+		xi = unit(engine);
+
+	coco_suite_t* const suite = coco_suite("bbob", "instances: 1", "");
+	std::vector<double> costs;
+	for (int f = 1; f <= 24; f++){
+		coco_problem_t* const problem = coco_suite_get_problem_by_function_dimension_instance(suite, f, dimension, 1);
+		if (!problem){
+			std::cerr << "Dimension " << dimension << " is not part of the bbob suite" << std::endl;
+			return 1;
+		}
+		costs.push_back(timeEvaluations(problem, X, evaluations) / dimension);
+		coco_problem_free(problem);
+	}
+
+	// The default configuration of experiment on the cheapest function, without the time of its evaluations
+	coco_problem_t* const problem = coco_suite_get_problem_by_function_dimension_instance(suite, 1, dimension, 1);
+	double const evaluation = timeEvaluations(problem, X, evaluations);
+	DifferentialEvolution de("costs", {"C", "RS", {{"RA1"}, {"B"}, "S", "CO", "EA", "WS", "AP"}});
+	double trial = INFINITY;
+	for (int r = 0; r < REPETITIONS; r++){
+		de.prepare(problem, popSize);
+		int const start = coco_problem_get_evaluations(problem);
+		auto const begin = std::chrono::steady_clock::now();
+		de.run(start + evaluations);
+		double const ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count();
+		trial = std::min(trial, ns / (coco_problem_get_evaluations(problem) - start));
+		de.reset();
+	}
+	coco_problem_free(problem);
+	coco_suite_free(suite);
+
+	std::cout << "# Measured by bench/costs at " << dimension << "-D with the " << level << " kernels, in ns per coordinate" << std::endl;
+	std::cout << "# The algorithm's own work per trial, then one evaluation of f1..f24" << std::endl;
+	std::cout << std::fixed << std::setprecision(1);
+	std::cout << (trial - evaluation) / dimension << std::endl;
+	for (int f = 1; f <= 24; f++)
+		std::cout << costs[f-1] << (f % 12 == 0 ? "\n" : " ");
+	return 0;
+}
@@ -0,0 +1,113 @@
+// Validates the vectorized bbob raw functions against the scalar code, then times them.
+// Build with `make bench`, then run ./simd [dimension] [evaluations]
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include "coco.h"
+
+static double const MAX_ULPS = 8; // Tolerance of the vectorized kernels, on the value of the bbob problem
+static int const REPETITIONS = 5; // Of the timings
+
+// Difference to the scalar reference in ULP of the larger of the raw function value and the optimal value
+// fopt added to it, since the cancellations in that sum say nothing about the kernels
+static double ulps(double const y, double const reference, double const fopt){
+	if (y != y || reference != reference) // NAN
+		return y != y && reference != reference ? 0 : INFINITY;
+	double const scale = std::max(std::abs(reference - fopt), std::abs(fopt));
+	return std::abs(y - reference) / (std::nextafter(scale, INFINITY) - scale);
+}
+
+int main(int argc, char** argv){
+	int const dimension = argc > 1 ? std::atoi(argv[1]) : 40;
+	int const evaluations = argc > 2 ? std::atoi(argv[2]) : 20000;
+	coco_set_log_level("error");
+
+	std::string const best = coco_set_simd_level("auto");
+	std::vector<std::string> levels;
+	for (std::string const level : {"sse2", "avx2"})
+		if (coco_set_simd_level(level.c_str()) == level)
+			levels.push_back(level);
+	if (levels.empty()){
+		std::cout << "No vectorized kernels on this CPU" << std::endl;
+		return 0;
+	}
+
+	// Random points in the domain, and far outside of it to exercise the argument reductions
+	std::mt19937_64 engine(1);
+	std::uniform_real_distribution<double> unit(-1, 1);
+	coco_suite_t* const suite = coco_suite("bbob", "instances: 1-3", "");
+	std::vector<double> worst(24, 0);
+	for (int f = 1; f <= 24; f++)
+	for (int const D : {2, 3, 5, 10, 20, 40})
+	for (int instance = 1; instance <= 3; instance++){
+		coco_problem_t* const problem = coco_suite_get_problem_by_function_dimension_instance(suite, f, D, instance);
+		double const fopt = coco_problem_get_final_target_fvalue1(problem) - 1e-8;
+		std::vector<double> x(D);
+		for (int k = 0; k < 200; k++){
+			double const scale = k % 4 == 3 ? 500 : 5;
+			for (double& xi : x)
+				xi = scale * unit(engine);
+			double reference;
+			coco_set_simd_level("none");
+			coco_evaluate_function(problem, x.data(), &reference);
+			for (std::string const& level : levels){
+				double y;
+				coco_set_simd_level(level.c_str());
+				coco_evaluate_function(problem, x.data(), &y);
+				worst[f-1] = std::max(worst[f-1], ulps(y, reference, fopt));
+			}
+		}
+		coco_problem_free(problem);
+	}
+	coco_suite_free(suite);
+
+	bool valid = true;
+	std::cout << "Largest difference to the scalar code (" << MAX_ULPS << " ULP allowed):" << std::endl;
+	for (int f = 1; f <= 24; f++){
+		std::cout << "  f" << std::setw(2) << std::left << f << std::right << std::setw(6) << std::fixed << std::setprecision(1)
+			<< worst[f-1] << " ULP";
+		std::cout << (worst[f-1] > MAX_ULPS ? "  FAILED" : "") << std::endl;
+		valid = valid && worst[f-1] <= MAX_ULPS;
+	}
+
+	std::cout << "D=" << dimension << ", ns per evaluation (none / " << best << "):" << std::endl;
+	coco_suite_t* const timed = coco_suite("bbob", "instances: 1", "");
+	std::vector<double> X(dimension * 100);
+	for (double& xi : X)
+		xi = 5 * unit(engine);
+	for (int f = 1; f <= 24; f++){
+		coco_problem_t* const problem = coco_suite_get_problem_by_function_dimension_instance(timed, f, dimension, 1);
+		if (!problem){
+			std::cerr << "Dimension " << dimension << " is not part of the bbob suite" << std::endl;
+			return 1;
+		}
+		// The levels alternate and the fastest repetition is kept, so that a slower phase of the machine does
+		// not count against one level
+		double ns[2] = {INFINITY, INFINITY}, sink = 0;
+		for (int r = 0; r < REPETITIONS; r++)
+		for (int l = 0; l < 2; l++){
+			coco_set_simd_level(l == 0 ? "none" : best.c_str());
+			auto const start = std::chrono::steady_clock::now();
+			for (int k = 0; k < evaluations; k++){
+				double y;
+				coco_evaluate_function(problem, &X[(k % 100) * dimension], &y);
+				sink += y;
+			}
+			ns[l] = std::min(ns[l], std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count()
+				/ evaluations);
+		}
+		std::cout << "  f" << std::setw(2) << std::left << f << std::right << std::fixed << std::setprecision(0)
+			<< std::setw(8) << ns[0] << std::setw(8) << ns[1] << std::setprecision(2) << std::setw(8)
+			<< ns[0] / ns[1] << "x" << (sink == 0 ? " " : "") << std::endl;
+		coco_problem_free(problem);
+	}
+	coco_suite_free(timed);
+	return valid ? 0 : 1;
+}
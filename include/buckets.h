@@ -0,0 +1,55 @@
+#pragma once
+#include <vector>
+
+// Non-owning view on a sequence of individual indices, such as a bucket of Buckets
+class Indices {
+	private:
+		int const* first;
+		int const* last;
+	public:
+		Indices(int const* first, int const* last): first(first), last(last){};
+		Indices(std::vector<int> const& indices): first(indices.data()), last(indices.data() + indices.size()){};
+		int const* begin() const {return first;}
+		int const* end() const {return last;}
+		int size() const {return last - first;}
+		bool empty() const {return first == last;}
+		int operator[](int const j) const {return first[j];}
+};
+
+// The indices 0..n-1 grouped by a key in 0..K-1, in a flat CSR layout: bucket k is indices[offsets[k]] up to
+// indices[offsets[k+1]], in ascending order. The buckets are filled by a counting sort over the keys, and the
+// arrays are reused, so grouping again does not allocate.
+class Buckets {
+	private:
+		std::vector<int> offsets; // K+1
+		std::vector<int> indices;
+	public:
+		// Groups the indices i for which keep(i) holds by keys[i]
+		template<typename Keys, typename Keep>
+		void build(int const K, Keys const& keys, int const n, Keep const& keep){
+			offsets.assign(K+1, 0);
+			for (int i = 0; i < n; i++)
+				if (keep(i))
+					offsets[keys[i]+1]++;
+			for (int k = 0; k < K; k++)
+				offsets[k+1] += offsets[k];
+			indices.reserve(n); // Room for every index, so that a larger bucket later does not allocate
+			indices.resize(offsets[K]);
+
+			// offsets[k] is the next free slot of bucket k while filling, which leaves it at the start of bucket k+1
+			for (int i = 0; i < n; i++)
+				if (keep(i))
+					indices[offsets[keys[i]]++] = i;
+			for (int k = K; k > 0; k--)
+				offsets[k] = offsets[k-1];
+			offsets[0] = 0;
+		}
+		template<typename Keys>
+		void build(int const K, Keys const& keys, int const n){
+			build(K, keys, n, [](int const){return true;});
+		}
+		int size() const {return int(offsets.size()) - 1;} // K
+		Indices operator[](int const k) const {
+			return Indices(indices.data() + offsets[k], indices.data() + offsets[k+1]);
+		}
+};
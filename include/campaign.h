@@ -0,0 +1,45 @@
+#pragma once
+#include <functional>
+#include <string>
+#include <vector>
+#include "coco.h"
+
+class Checkpoint;
+
+// A single optimization run on one problem instance
+struct CampaignTask {
+	int index; // Position of the run in a serial campaign, which determines where its output is merged
+	size_t function, dimension, instance;
+	std::string id; // Identifier of the task's own output (COCO result folder and extra_data files)
+	std::string resultFolder;
+	double cost; // Expected running time in arbitrary units, used to schedule long tasks first
+	std::string checkpoint; // Path of the checkpoint files of the task without extension, empty if disabled
+	Checkpoint* resumed; // An interrupted attempt to continue, at the state of the solver; nullptr if none
+	// Saves a checkpoint of the task: its result folder, the state of its COCO problem and then the state of
+	// the solver, as written by state. The solver restores the latter from resumed.
+	void save(coco_problem_t* const problem, std::function<void(Checkpoint&)> const& state) const;
+};
+
+// Runs all (function, dimension, instance, run) tasks of a suite on a number of worker threads, longest
+// expected first and with work stealing between the workers (see TaskQueues in campaign.cc). Every task
+// gets its own problem and observer, and logs to its own COCO result folder and extra_data files. Once all
+// tasks are done, these are merged in task order into the layout of a serial run.
+//
+// With checkpoints (params::checkpoint_interval), a completed task leaves a marker in params::checkpoint_path,
+// and the solver saves checkpoints of the running tasks there (see CampaignTask::save). A campaign run again
+// with params::resume skips the completed tasks and continues the interrupted ones from their checkpoints.
+class Campaign {
+	private:
+		std::string const suiteName, observerName, id;
+		std::vector<CampaignTask> tasks;
+		void runTask(CampaignTask& task, std::function<void(CampaignTask const&, coco_problem_t*)> const& solve);
+		void carryOver(std::string const from, std::string const to, size_t const evaluations) const;
+		void mergeResults() const;
+		void mergeExtraData() const;
+	public:
+		Campaign(std::string const suiteName, std::string const suiteInstances, std::string const suiteOptions, 
+				std::string const observerName, std::string const id);
+		int size() const;
+		void run(int const jobs, std::function<double(CampaignTask const&)> const& cost, 
+				std::function<void(CampaignTask const&, coco_problem_t*)> const& solve);
+};
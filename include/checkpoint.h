@@ -0,0 +1,49 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "Eigen/Dense"
+
+// The state of an interrupted run, as a sequence of values in host byte order: every stateful object writes
+// its state in save() and reads it back, in the same order, in restore(). A checkpoint is saved to a temporary
+// file that is then renamed over the previous checkpoint, so the file always holds a complete one.
+class Checkpoint {
+	private:
+		std::vector<char> data;
+		std::size_t position = 0; // Of the next value to read
+	public:
+		Checkpoint(){};
+		Checkpoint(std::string const filename); // Throws std::invalid_argument if it is not a checkpoint file
+		void save(std::string const filename) const;
+		void write(void const* value, std::size_t const size);
+		void read(void* value, std::size_t const size); // Throws std::runtime_error past the end
+		void append(Checkpoint const& other); // The values of other that have not been read yet
+
+		template <typename T>
+		typename std::enable_if<std::is_arithmetic<T>::value>::type write(T const value){
+			write(&value, sizeof(value));
+		}
+		template <typename T>
+		typename std::enable_if<std::is_arithmetic<T>::value>::type read(T& value){
+			read(&value, sizeof(value));
+		}
+
+		void write(std::string const& s);
+		void read(std::string& s);
+
+		template <typename Derived>
+		void write(Eigen::PlainObjectBase<Derived> const& v){
+			write(int64_t(v.rows()));
+			write(int64_t(v.cols()));
+			write(v.data(), v.size() * sizeof(typename Derived::Scalar));
+		}
+		template <typename Derived>
+		void read(Eigen::PlainObjectBase<Derived>& v){
+			int64_t rows, cols;
+			read(rows);
+			read(cols);
+			v.resize(rows, cols);
+			read(v.data(), v.size() * sizeof(typename Derived::Scalar));
+		}
+};
@@ -287,6 +287,18 @@ coco_problem_t *coco_problem_remove_observer(coco_problem_t *problem, coco_obser
  */
 const char *coco_observer_get_result_folder(const coco_observer_t *observer);
 
+/**
+ * @brief Saves the evaluation state of an observed problem (counters, best values and logger state) in state,
+ * if not NULL, and returns the number of its values.
+ */
+size_t coco_problem_save_state(const coco_problem_t *problem, double *state);
+
+/**
+ * @brief Restores the evaluation state saved by coco_problem_save_state() into a fresh, identically observed
+ * problem.
+ */
+void coco_problem_restore_state(coco_problem_t *problem, const double *state);
+
 /**@}*/
 
 /***********************************************************************************************************/
@@ -300,6 +312,35 @@ const char *coco_observer_get_result_folder(const coco_observer_t *observer);
  */
 void coco_evaluate_function(coco_problem_t *problem, const double *x, double *y);
 
+/**
+ * @brief Records an evaluation in point x whose function value y was computed beforehand, e.g. by
+ * coco_compute_function().
+ */
+void coco_evaluate_function_given(coco_problem_t *problem, const double *x, double *y);
+
+/**
+ * @brief Evaluates the problem function in the n points stored one after the other in x and saves the
+ * results in y.
+ */
+void coco_evaluate_function_batch(coco_problem_t *problem, const double *x, const size_t n, double *y);
+
+/**
+ * @brief Computes the function value in point x without recording the evaluation; may be called by several
+ * threads at once on the same problem.
+ */
+void coco_compute_function(coco_problem_t *problem, const double *x, double *y);
+
+/**
+ * @brief Computes the function values in the n points stored one after the other in x without recording the
+ * evaluations; may be called by several threads at once on the same problem.
+ */
+void coco_compute_function_batch(coco_problem_t *problem, const double *x, const size_t n, double *y);
+
+/**
+ * @brief Returns a new, unobserved instance of the same problem, which can be evaluated from another thread.
+ */
+coco_problem_t *coco_problem_clone(const coco_problem_t *problem);
+
 /**
  * @brief Evaluates the problem constraints in point x and save the result in y.
  */
@@ -496,6 +537,12 @@ void coco_debug(const char *message, ...);
  * @brief Sets the COCO log level to the given value and returns the previous value of the log level.
  */
 const char *coco_set_log_level(const char *level);
+
+/**
+ * @brief Selects the instruction set of the vectorized bbob raw functions ("none", "sse2", "avx2" or "auto")
+ * and returns the one in effect.
+ */
+const char *coco_set_simd_level(const char *level);
 /**@}*/
 
 /***********************************************************************************************************/
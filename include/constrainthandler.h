@@ -1,9 +1,11 @@
 #pragma once
 #include "Eigen/Dense"
 #include "params.h"
+#include "population.h"
 
 using Eigen::ArrayXd;
-class Solution;
+
+class Checkpoint;
 
 class ConstraintHandler {
 	protected:
@@ -16,48 +18,50 @@ class ConstraintHandler {
 			create(std::string const id);
 		ConstraintHandler(ArrayXd const lb, ArrayXd const ub): lb(lb), ub(ub), D(lb.size()), nCorrected(0){};
 		virtual ~ConstraintHandler(){};
-		virtual bool resample(Solution* const p, int const resamples);
-		virtual void penalize(Solution* const /*p*/){};
-		virtual void repair(Solution* const /*p*/, Solution const * const /*base*/, Solution const* const /*target*/){}; // DE constraint handler
-		virtual void repair(Solution* const /*p*/){};// Generic constraint handler
+		virtual bool resample(Column x, int const resamples);
+		virtual void penalize(Population& /*population*/, int const /*i*/){};
+		virtual void repair(Column /*x*/, ConstColumn const& /*base*/, ConstColumn const& /*target*/){}; // DE constraint handler
+		virtual void repair(Column /*x*/){};// Generic constraint handler
 		int getCorrections() const;
-		bool isFeasible(Solution const * const p) const;
+		void save(Checkpoint& checkpoint) const; // The correction counter
+		void restore(Checkpoint& checkpoint);
+		bool isFeasible(ConstColumn const& x) const;
 };
 
 class RandBaseRepair : public ConstraintHandler {
 	public:
 		RandBaseRepair(ArrayXd const lb, ArrayXd const ub):ConstraintHandler(lb,ub){};
-		void repair(Solution* const p, Solution const* const base, Solution const* const target);
+		void repair(Column x, ConstColumn const& base, ConstColumn const& target);
 };
 
 class MidpointBaseRepair : public ConstraintHandler{
 	public:
 		MidpointBaseRepair(ArrayXd const lb, ArrayXd const ub): ConstraintHandler(lb,ub) {};
-		void repair(Solution* const p, Solution const* const base, Solution const* const target);
+		void repair(Column x, ConstColumn const& base, ConstColumn const& target);
 };
 
 class MidpointTargetRepair : public ConstraintHandler {
 	public:
 		MidpointTargetRepair(ArrayXd const lb, ArrayXd const ub):ConstraintHandler(lb,ub){};
-		void repair(Solution* const p, Solution const * const base, Solution const* const target);
+		void repair(Column x, ConstColumn const& base, ConstColumn const& target);
 };
 
 class ProjectionMidpointRepair : public ConstraintHandler {
 	public:
 		ProjectionMidpointRepair(ArrayXd const lb, ArrayXd const ub):ConstraintHandler(lb,ub){};
-		void repair(Solution* const p, Solution const* const base, Solution const* const target);
+		void repair(Column x, ConstColumn const& base, ConstColumn const& target);
 };
 
 class ProjectionBaseRepair: public ConstraintHandler {
 	public:
 		ProjectionBaseRepair(ArrayXd const lb, ArrayXd const ub):ConstraintHandler(lb,ub){};
-		void repair(Solution* const p, Solution const* const base, Solution const* const target);
+		void repair(Column x, ConstColumn const& base, ConstColumn const& target);
 };
 
 class ConservatismRepair : public ConstraintHandler {
 	public:
 		ConservatismRepair(ArrayXd const lb, ArrayXd const ub):ConstraintHandler(lb,ub){};
-		void repair(Solution* const p, Solution const* const base, Solution const* const target);
+		void repair(Column x, ConstColumn const& base, ConstColumn const& target);
 };
 
 class ResamplingRepair : public ConstraintHandler {
@@ -66,47 +70,47 @@ class ResamplingRepair : public ConstraintHandler {
 	public:
 		ResamplingRepair(ArrayXd const lb, ArrayXd const ub)
 			:ConstraintHandler(lb,ub){};
-		bool resample(Solution * const p, int const resamples);
+		bool resample(Column x, int const resamples);
 };
 
 class DeathPenalty : public ConstraintHandler {
 	public:
 		DeathPenalty(ArrayXd const lb,ArrayXd const ub):ConstraintHandler(lb,ub){};
-		void penalize(Solution* const p);
+		void penalize(Population& population, int const i);
 };
 
 class ReinitializationRepair : public ConstraintHandler {
 	public:
 		ReinitializationRepair(ArrayXd const lb, ArrayXd const ub)
 			:ConstraintHandler(lb,ub){}; 
-		void repair(Solution* const p);
+		void repair(Column x);
 };
 
 class ProjectionRepair : public ConstraintHandler {
 	public:
 		ProjectionRepair(ArrayXd const lb, ArrayXd const ub)
 			:ConstraintHandler(lb,ub){};
-		void repair(Solution* const p);
+		void repair(Column x);
 };
 
 class ReflectionRepair : public ConstraintHandler{
 	public:
 		ReflectionRepair(ArrayXd const lb, ArrayXd const ub)
 			:ConstraintHandler(lb,ub){}; 
-		void repair(Solution* const p);
+		void repair(Column x);
 };
 
 class WrappingRepair : public ConstraintHandler {
 	public:
 		WrappingRepair(ArrayXd const lb, ArrayXd const ub):ConstraintHandler(lb,ub){};
-		void repair(Solution* const p);
+		void repair(Column x);
 };
 
 class TransformationRepair : public ConstraintHandler { //Adapted from https://github.com/psbiomech/c-cmaes
 	private:
 		ArrayXd al, au, xlo, xhi, r;
-		bool shift(Solution* const p);
+		bool shift(Column x);
 	public:
 		TransformationRepair(ArrayXd const lb, ArrayXd const ub);
-		void repair(Solution* const p);
+		void repair(Column x);
 };
@@ -9,38 +9,39 @@ class CreditManager {
 		static std::function<CreditManager* ()> create(std::string const id);
 		CreditManager(){};
 		virtual ~CreditManager (){};
-		virtual ArrayXd getCredit(ArrayXd const& fitnessDeltas, ArrayXd const& previousDistances, 
-				ArrayXd const& currentDistances) const=0;
+		// Writes the credit of every trial, without allocating
+		virtual void getCredit(ArrayXd const& fitnessDeltas, ArrayXd const& previousDistances, 
+				ArrayXd const& currentDistances, ArrayXd& credit) const=0;
 };
 
 class FitnessScaledByDiversityRatio : public CreditManager {
 	public:
-		ArrayXd getCredit(ArrayXd const& fitnessDeltas, ArrayXd const& previousDistances, 
-				ArrayXd const& currentDistances) const;
+		void getCredit(ArrayXd const& fitnessDeltas, ArrayXd const& previousDistances, 
+				ArrayXd const& currentDistances, ArrayXd& credit) const;
 };
 
 class FitnessScaledBySquaredDiversityRatio : public CreditManager {
 	public:
-		ArrayXd getCredit(ArrayXd const& fitnessDeltas, ArrayXd const& previousDistances, 
-				ArrayXd const& currentDistances) const;
+		void getCredit(ArrayXd const& fitnessDeltas, ArrayXd const& previousDistances, 
+				ArrayXd const& currentDistances, ArrayXd& credit) const;
 };
 
 class DiversityRatio : public CreditManager {
 	public:
-		ArrayXd getCredit(ArrayXd const& fitnessDeltas, ArrayXd const& previousDistances, 
-				ArrayXd const& currentDistances) const;
+		void getCredit(ArrayXd const& fitnessDeltas, ArrayXd const& previousDistances, 
+				ArrayXd const& currentDistances, ArrayXd& credit) const;
 };
 
 class SquaredDiversityRatio: public CreditManager {
 	public:
-		ArrayXd getCredit(ArrayXd const& fitnessDeltas, ArrayXd const& previousDistances, 
-				ArrayXd const& currentDistances) const;
+		void getCredit(ArrayXd const& fitnessDeltas, ArrayXd const& previousDistances, 
+				ArrayXd const& currentDistances, ArrayXd& credit) const;
 };
 
 class FitnessImprovement : public CreditManager {
 	public:
-		ArrayXd getCredit(ArrayXd const& fitnessDeltas, ArrayXd const& previousDistances, 
-				ArrayXd const& currentDistances) const;
+		void getCredit(ArrayXd const& fitnessDeltas, ArrayXd const& previousDistances, 
+				ArrayXd const& currentDistances, ArrayXd& credit) const;
 };
 
 class Compass : public CreditManager {
@@ -49,12 +50,12 @@ class Compass : public CreditManager {
 		Vector2d const c;
 	public:
 		Compass() : c(cos(omega), sin(omega)){};
-		ArrayXd getCredit(ArrayXd const& fitnessDeltas, ArrayXd const& previousDistances, 
-				ArrayXd const& currentDistances) const;
+		void getCredit(ArrayXd const& fitnessDeltas, ArrayXd const& previousDistances, 
+				ArrayXd const& currentDistances, ArrayXd& credit) const;
 };
 
 class ParetoDominance : public CreditManager {
 	public: 
-		ArrayXd getCredit(ArrayXd const& fitnessDeltas, ArrayXd const& previousDistances, 
-				ArrayXd const& currentDistances) const;
+		void getCredit(ArrayXd const& fitnessDeltas, ArrayXd const& previousDistances, 
+				ArrayXd const& currentDistances, ArrayXd& credit) const;
 };
@@ -1,31 +1,49 @@
 #pragma once
-#include "solution.h"
+#include <functional>
+#include <string>
+#include <vector>
+#include "population.h"
+#include "buckets.h"
 
+using Eigen::ArrayXXd;
+
+// Crossover operates on a batch of individuals: for every i in indices, trial i is created from column i
+// of the targets and column i of the donors, with crossover rate Crs(i).
 class CrossoverManager {
 	public:
 		static std::function<CrossoverManager* ()> create(std::string const id);
 		CrossoverManager(){};
 		virtual ~CrossoverManager(){};
-		virtual Solution* crossover(Solution const* const target, 
-				Solution const* const donor, double const Cr) const = 0;
+		virtual void crossover(ArrayXXd const& targets, ArrayXXd const& donors, ArrayXd const& Crs, 
+				Indices const indices, Population& trials) const = 0;
 };
 
 class BinomialCrossoverManager : public CrossoverManager {
+	private:
+		mutable ArrayXXd uniforms; // Reused buffer for the draws of a whole batch
+		mutable ArrayXd donor; // Reused buffer for the donors of the fused trial kernels
 	public:
 		BinomialCrossoverManager(){};
-		Solution* crossover(Solution const* const target, Solution const* const donor, double const Cr) const;
+		void crossover(ArrayXXd const& targets, ArrayXXd const& donors, ArrayXd const& Crs, 
+				Indices const indices, Population& trials) const;
+		// The steps of crossover(), which the trial kernels interleave with the mutation (see trialkernel.cc):
+		// draw the uniforms of a batch of n of the targets, then cross the j-th individual of the batch over
+		void draw(ArrayXXd const& targets, int const n) const;
+		void cross(int const j, ConstColumn const& target, ConstColumn const& donor, double const Cr,
+				ArrayXXd::ColXpr trial) const;
+		Column getDonor(int const D) const;
 };
 
 class ExponentialCrossoverManager : public CrossoverManager {
 	public:
 		ExponentialCrossoverManager(){};
-		Solution* crossover(Solution const* const target, 
-				Solution const* const donor, double const Cr) const;
+		void crossover(ArrayXXd const& targets, ArrayXXd const& donors, ArrayXd const& Crs, 
+				Indices const indices, Population& trials) const;
 };
 
 class ArithmeticCrossoverManager : public CrossoverManager {
 	public:
 		ArithmeticCrossoverManager(){};
-		Solution* crossover(Solution const* const target, 
-				Solution const* const donor, double const Cr) const;
+		void crossover(ArrayXXd const& targets, ArrayXXd const& donors, ArrayXd const& Crs, 
+				Indices const indices, Population& trials) const;
 };
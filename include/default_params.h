@@ -11,6 +11,9 @@ int params::log_positions_interval = 10;
 bool params::log_repairs = false;
 int params::log_repairs_interval = 10;
 std::string params::extra_data_path = "./extra_data";
+int params::log_buffer = 1024;
+std::string params::log_policy = "BLOCK";
+std::string params::log_format = "TEXT";
 Eigen::IOFormat const params::vecFmt(Eigen::StreamPrecision, Eigen::DontAlignCols, " ", "", "", "", "", "");
 
 // DE
@@ -19,6 +22,19 @@ double params::Cr = 0.9;
 double params::popsize_multiplier = 5;
 double params::convergence_delta = 1e-9;
 bool params::restart_on_convergence = true;
+int params::threads = 1;
+bool params::asynchronous = false;
+
+// Checkpoints
+int params::checkpoint_interval = 0;
+std::string params::checkpoint_path = "./checkpoints";
+bool params::resume = false;
+
+// Island model
+int params::islands = 1;
+std::string params::topology = "RING";
+int params::migration_interval = 10;
+int params::migration_size = 1;
 
 double params::CO_omega = pi()/4.;
 
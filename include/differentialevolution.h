@@ -1,14 +1,19 @@
 #pragma once
+#include <functional>
 #include <vector>
 #include <string>
 #include "coco.h"
 #include "strategyadaptationmanager.h"
-#include "logger.h"
+#include "extradata.h"
+#include "population.h"
+#include "params.h"
 
 class ParameterAdaptationManager;
 class StrategyAdaptationManager;
-class Solution;
 class ConstraintHandler;
+class ThreadPool;
+class IslandModel;
+class Checkpoint;
 
 struct DEConfig {
 	std::string const strategy, constraintHandler;
@@ -18,24 +23,49 @@ struct DEConfig {
 class DifferentialEvolution {
 	public:
 		std::string const id;
-		DifferentialEvolution(std::string const id, DEConfig const config);
+		// Trials are computed on threads threads, params::threads unless the caller splits them (see IslandModel)
+		DifferentialEvolution(std::string const id, DEConfig const config, int const threads = params::threads);
 		virtual ~DifferentialEvolution();
 		void run(int const evalBudget);
+		void runAsynchronous(int const evalBudget);
 		void run(coco_problem_t* problem, int const evalBudget, int const popSize);
 		void prepare(coco_problem_t* problem, int const popSize);
 		void reset();
-		bool converged(std::vector<Solution*>const& population) const;
+		bool converged(Population const& population) const;
+		void join(IslandModel* const model, int const island); // Run as one island of model (see IslandModel)
+		// Checkpoints of the generational run(), not of runAsynchronous() or islands: save is called every
+		// params::checkpoint_interval evaluations between two generations, when the state of the run is complete.
+		void setCheckpoint(std::function<void()> const save);
+		void save(Checkpoint& checkpoint);
+		void resume(coco_problem_t* problem, int const evalBudget, Checkpoint& checkpoint); // restore -> run -> reset
 	private:
 		DEConfig const config;
-		std::vector<Solution*> genomes;
+		Population genomes; // Persistent buffers, allocated once in prepare()
+		Population trials;
+		ArrayXXd donors;
+		ArrayXd values; // Function values computed by the thread pool, before they are committed
 		ConstraintHandler* ch;
 		StrategyAdaptationManager* strategyAdaptationManager;
 		int popSize;
 		int D;
 		coco_problem_t* problem;
-		Logger activationsLogger;
-		Logger parameterLogger;
-		Logger positionsLogger;
-		Logger diversityLogger;
-		Logger repairsLogger;
+		ExtraDataLog activationsLogger;
+		ExtraDataLog parameterLogger;
+		ExtraDataLog positionsLogger;
+		ExtraDataLog diversityLogger;
+		ExtraDataLog repairsLogger;
+		ArrayXi parameters; // F and Cr of each individual in percent, as logged
+		int const threads;
+		ThreadPool* pool; // Only used with more than one thread
+		IslandModel* model; // Only set for islands, which compute their trials and commit them to the model
+		int island;
+		std::vector<int> fresh; // Trials evaluated in the current generation
+		int iteration;
+		ArrayXi recentActivations; // Since the last activations logged
+		std::function<void()> checkpoint;
+		size_t nextCheckpoint; // Evaluations
+		void restore(coco_problem_t* const problem, Checkpoint& checkpoint);
+		bool exhausted(int const evalBudget) const;
+		void log(int const iteration, ArrayXd const& Fs, ArrayXd const& Crs, ArrayXi& recentActivations);
+		void evaluateTrials();
 };
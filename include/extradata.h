@@ -0,0 +1,76 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "logger.h"
+
+using Eigen::ArrayXd;
+using Eigen::ArrayXi;
+
+// The extra_data logs of a DE instance, one file per kind, in the TEXT or BINARY format of params::log_format.
+// Each problem (or restart) is a section with one record per logged generation; in the text format, it starts
+// with the problem ID and ends with a blank line, except for the positions, which have a blank line after
+// each generation instead.
+//
+// The BINARY format (file name + ".bin") is self-describing, in little-endian byte order:
+//   file header:    char[4] "DEXD", uint32 version, int32 kind
+//   section header: string problem ID, int32 D, NP, interval, number of configurations, then each
+//                   configuration ID as a string; int32 type of the values (0: int32, 1: float64), int32 columns
+//   record:         int32 generation, then columns values of the given type
+//   section end:    int32 -1
+// where a string is a uint32 length followed by its bytes. Records per kind: ACTIVATIONS, the activations of
+// each configuration (int32); PARAMETERS, F and Cr of each individual in percent (int32 pairs); POSITIONS, the
+// individuals one after the other (float64); DIVERSITY and REPAIRS, a single float64.
+enum ExtraDataKind : int32_t {ACTIVATIONS, PARAMETERS, POSITIONS, DIVERSITY, REPAIRS};
+
+class ExtraDataLog {
+	private:
+		Logger logger;
+		ExtraDataKind const kind;
+		bool const binary;
+		bool started = false; // The file header is written
+		int D = 0, NP = 0, configurations = 0;
+		int columns() const;
+		void writeString(std::string const& s);
+	public:
+		ExtraDataLog(std::string const filename, ExtraDataKind const kind);
+		ExtraDataLog(std::string const filename, ExtraDataKind const kind, bool const binary);
+		void begin(std::string const& problem, int const D, int const NP, int const interval,
+				std::vector<std::string> const& configurations = std::vector<std::string>());
+		void record(int const generation, int const* values);
+		void record(int const generation, double const* values);
+		void end();
+		void save(Checkpoint& checkpoint); // The size of the file and the section in progress
+		void restore(Checkpoint& checkpoint); // Continues the section in progress, instead of begin()
+};
+
+struct ExtraDataSection {
+	std::string problem;
+	int D, NP, interval;
+	std::vector<std::string> configurations;
+	bool floating; // float64 values, int32 otherwise
+	int columns;
+	char const* records; // Inside the mapping of the reader
+	std::size_t count;
+	bool complete; // False if the file ends before the end of the section
+	int generation(std::size_t const record) const;
+	double value(std::size_t const record, int const column) const;
+};
+
+// Maps a binary extra_data file into memory; the sections point into the mapping, which lives as long as the
+// reader. Files appended to one another, as merged by a Campaign, read as one. Throws std::invalid_argument on
+// files that cannot be read or are not in the binary format.
+class ExtraDataReader {
+	private:
+		char const* data;
+		std::size_t size;
+		ExtraDataKind kind;
+		std::vector<ExtraDataSection> sections;
+	public:
+		ExtraDataReader(std::string const filename);
+		~ExtraDataReader();
+		ExtraDataReader(ExtraDataReader const&) = delete;
+		ExtraDataReader& operator=(ExtraDataReader const&) = delete;
+		ExtraDataKind getKind() const;
+		std::vector<ExtraDataSection> const& getSections() const;
+};
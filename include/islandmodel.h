@@ -0,0 +1,59 @@
+#pragma once
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "coco.h"
+#include "differentialevolution.h"
+
+// Lock-free single-producer single-consumer ring of migrants from one island to another. The slots are
+// allocated once; push and pop only publish the tail and head indices, so neither side blocks or allocates.
+class MigrationChannel {
+	private:
+		ArrayXXd positions;
+		ArrayXd fitness;
+		unsigned int const mask; // Capacity - 1, the capacity is a power of two
+		std::atomic<unsigned int> head; // Next slot to read, written by the consumer only
+		char padding[64]; // Keeps head and tail on separate cache lines
+		std::atomic<unsigned int> tail; // Next slot to write, written by the producer only
+	public:
+		MigrationChannel(int const D, int const capacity);
+		bool push(ConstColumn const& x, double const f); // False when full, the migrant is then dropped
+		bool pop(ArrayXd& x, double& f); // False when empty
+};
+
+// Runs several DifferentialEvolution instances (islands) on one problem, each on its own share of
+// params::threads (at least one thread), and with its own operators, strategy adaptation and constraint
+// handler. Every params::migration_interval generations, an island sends its params::migration_size best
+// individuals to its neighbours, and receives migrants that replace its worst individuals when better.
+// Neighbours follow a topology:
+// RING (i -> i+1), STAR (hub 0 <-> every other island) or RANDOM (one island drawn per migration).
+// The islands compute their trials on the shared problem and share its budget: an island reserves the
+// evaluations of a generation before computing it, so the last generations are cut to the budget left and
+// the run never overshoots it. The values are committed to the observed problem under a lock, so COCO logs
+// every evaluation once. Island runs are not reproducible, even with a fixed seed: the order in which the
+// islands reserve and commit, and the migrants they receive, depend on the scheduling of their threads.
+class IslandModel {
+	public:
+		std::string const id;
+		IslandModel(std::string const id, DEConfig const config, int const islands, std::string const topology);
+		~IslandModel();
+		void run(coco_problem_t* const problem, int const evalBudget, int const popSize);
+		bool exhausted() const; // Budget reserved or final target hit
+		int reserve(int const n); // Takes up to n evaluations of the budget, returns how many it got
+		void commit(Population const& population, std::vector<int> const& indices);
+		void migrate(int const island, Population& genomes);
+	private:
+		std::string const topology;
+		std::vector<DifferentialEvolution*> islands;
+		std::vector<MigrationChannel*> channels;
+		std::vector<std::vector<MigrationChannel*>> outgoing, incoming; // Per island
+		std::vector<ArrayXd> received; // Per island buffer for a single migrant
+		std::mutex mutex; // Serializes the commits to the observed problem
+		coco_problem_t* problem;
+		std::atomic<long> evaluations; // Reserved, committed or about to be
+		long budget;
+		std::atomic<bool> targetHit;
+		void connect(int const from, int const to, int const D);
+		void disconnect();
+};
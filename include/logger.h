@@ -1,24 +1,114 @@
 #pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstring>
 #include <fstream>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
 #include "Eigen/Dense"
 #include <iomanip>
 
+class Checkpoint;
+
+// Writes a text file in the background. log() appends binary records (numbers, strings, vectors) to a bounded
+// single-producer single-consumer ring, and a writer thread shared by all loggers formats them into the file.
+// Lines are published whole. When the ring is full, the producer waits for the writer (params::log_policy
+// BLOCK) or drops the line (DROP). A logger must only be written from one thread at a time.
 class Logger {
 	private:
+		enum Tag : char {INT, DOUBLE, STRING, INTS, DOUBLES, NEWLINE, RAW};
 		std::ofstream out;
 		std::string const filename;
 		bool activated = false;
+		bool const blocking;
+		std::vector<char> ring; // Allocated on activation, the capacity is a power of two
+		std::size_t mask = 0;
+		std::atomic<std::size_t> head; // Next byte to format, written under the lock of the writer
+		char padding[64]; // Keeps head and tail on separate cache lines
+		std::atomic<std::size_t> tail; // End of the published lines, written by the producer only
+		std::size_t end = 0; // End of the records of the line in progress, written by the producer only
+		bool dropping = false; // The line in progress is dropped
+		bool kept = false; // The line in progress waits for room even under the DROP policy
+		long dropped = 0; // Lines
+		bool reserve(std::size_t const size);
+		void append(void const* data, std::size_t const size);
+		void publish();
+		void finishLine();
+		void read(std::size_t const position, void* data, std::size_t const size) const;
+		void open(std::ios::openmode const mode);
+		friend class LogWriter;
+		void drain(); // Formats the published records, under the lock of the writer
+
+		template <typename T>
+		void put(Tag const tag, T const value){
+			if (reserve(1 + sizeof(T))){
+				append(&tag, 1);
+				append(&value, sizeof(T));
+			}
+		}
+		template <typename T>
+		typename std::enable_if<std::is_integral<T>::value>::type record(T const t){
+			put(INT, int64_t(t));
+		}
+		template <typename T>
+		typename std::enable_if<std::is_floating_point<T>::value>::type record(T const t){
+			put(DOUBLE, double(t));
+		}
+		void record(char const* s){
+			record(s, std::strlen(s));
+		}
+		void record(std::string const& s){
+			record(s.data(), s.size());
+		}
+		void record(char const* s, std::size_t const length);
+		template <typename T>
+		typename std::enable_if<!std::is_arithmetic<T>::value>::type record(T const& t){
+			std::ostringstream formatted; // Anything else is formatted by the producer
+			formatted << t;
+			record(formatted.str());
+		}
 	public:
-		Logger(std::string filename) : filename(filename){};
+		Logger(std::string filename);
 		~Logger();
 		void checkActive();
 
 		template <typename T>
 		void log(T const& t, bool const newline = true){
 			checkActive();
-			out << t;
+			record(t);
+			if (newline)
+				endLine();
+		}
+
+		// Logs the coefficients of v on one line as a row vector; format must outlive the logger
+		template <typename Derived>
+		void log(Eigen::DenseBase<Derived> const& v, Eigen::IOFormat const& format, bool const newline = true){
+			typedef typename std::conditional<std::is_integral<typename Derived::Scalar>::value, int64_t, double>::type
+				Value;
+			checkActive();
+			uint32_t const n = v.size();
+			Tag const tag = std::is_integral<typename Derived::Scalar>::value ? INTS : DOUBLES;
+			Eigen::IOFormat const* const f = &format;
+			if (reserve(1 + sizeof(f) + sizeof(n) + n * sizeof(Value))){
+				append(&tag, 1);
+				append(&f, sizeof(f));
+				append(&n, sizeof(n));
+				for (Eigen::Index i = 0; i < v.size(); i++){
+					Value const value = v.derived().coeff(i);
+					append(&value, sizeof(value));
+				}
+			}
 			if (newline)
-				out << "\n";
+				endLine();
 		}
-		void flush();
+
+		void endLine();
+		// Logs size raw bytes, written out as they are. The end of a record publishes it like the end of a line;
+		// a record that must not be dropped waits for room under either policy.
+		void write(void const* data, std::size_t const size, bool const end = true, bool const droppable = true);
+		void flush(); // Writes out everything logged so far, including the line in progress
+		void save(Checkpoint& checkpoint); // Writes out the published lines and saves the size of the file
+		void restore(Checkpoint& checkpoint); // Cuts the file back to its saved size, to continue it
 };
@@ -1,135 +1,166 @@
 #pragma once
 #include <map>
 #include "constrainthandler.h"
+#include "population.h"
+#include "util.h"
 #include "Eigen/Dense"
 
 using Eigen::ArrayXXd;
+using Eigen::MatrixXd;
 
 class MutationManager {
 	protected:
 		ConstraintHandler* const ch;
-		virtual Solution* doMutation(std::vector<Solution*>const& genomes, int const i, double const F) const=0;
+		virtual void doMutation(Population const& genomes, int const i, double const F, Column donor) const=0;
 	public:
 		static std::function<MutationManager* (ConstraintHandler* const)> create(std::string const id);
 		MutationManager(ConstraintHandler * const ch):ch(ch){};
 		virtual ~MutationManager(){};
-		virtual void prepare(std::vector<Solution*>const& /*genomes*/){};
-		Solution* mutate(std::vector<Solution*>const& genomes, int const i, double const F);
-};
+		virtual void prepare(Population const& /*genomes*/){};
+		template <class Operator>
+		void mutate(Population const& genomes, int const i, double const F, Column donor);
+};
+
+// Mutation followed by resampling and the generic repair. Operator is the dynamic type of this manager,
+// its doMutation is called directly instead of through the vtable.
+template <class Operator>
+void MutationManager::mutate(Population const& genomes, int const i, double const F, Column donor){
+	Operator const& op = static_cast<Operator const&>(*this);
+	int resamples = 0;
+	do {
+		op.Operator::doMutation(genomes, i, F, donor);
+	} while (ch->resample(donor, resamples++));
+	ch->repair(donor); //generic repair
+}
 
 class Rand1MutationManager : public MutationManager {
 	public:
 		Rand1MutationManager(ConstraintHandler* const ch): MutationManager(ch){};
-		Solution* doMutation(std::vector<Solution*>const& genomes, int const i, double const F) const;
+		void doMutation(Population const& genomes, int const i, double const F, Column donor) const;
 };
 
 class TTB1MutationManager : public MutationManager {
 	private:
-		Solution const* best;
+		int best;
 	public:
 		TTB1MutationManager(ConstraintHandler* const ch): MutationManager(ch){};
-		void prepare(std::vector<Solution*>const& genomes);
-		Solution* doMutation(std::vector<Solution*>const& genomes, int const i, double const F) const;
+		void prepare(Population const& genomes);
+		void doMutation(Population const& genomes, int const i, double const F, Column donor) const;
 };
 
 class TTR1MutationManager : public MutationManager {
 	public:
 		TTR1MutationManager(ConstraintHandler* const ch): MutationManager(ch){};
-		Solution* doMutation(std::vector<Solution*>const& genomes, int const i, double const F) const;
+		void doMutation(Population const& genomes, int const i, double const F, Column donor) const;
 };
 
 class TTB2MutationManager : public MutationManager {
 	private:
-		Solution const* best;
+		int best;
 	public:
 		TTB2MutationManager(ConstraintHandler* const ch): MutationManager(ch){};
-		void prepare(std::vector<Solution*>const& genomes);
-		Solution* doMutation(std::vector<Solution*>const& genomes, int const i, double const F) const;
+		void prepare(Population const& genomes);
+		void doMutation(Population const& genomes, int const i, double const F, Column donor) const;
 };
 
 class TTPB1MutationManager : public MutationManager {
 	private:
-		std::vector<Solution*> sorted;
+		std::vector<int> sorted;
 	public:
 		TTPB1MutationManager(ConstraintHandler* const ch): MutationManager(ch){};
-		void prepare(std::vector<Solution*>const& genomes);
-		Solution* doMutation(std::vector<Solution*>const& genomes, int const i, double const F) const;
+		void prepare(Population const& genomes);
+		void doMutation(Population const& genomes, int const i, double const F, Column donor) const;
 };
 
 class Best1MutationManager: public MutationManager {
 	private:
-		Solution const* best;
+		int best;
 	public:
 		Best1MutationManager(ConstraintHandler* const ch):MutationManager(ch){};
-		void prepare(std::vector<Solution*>const& genomes);
-		Solution* doMutation(std::vector<Solution*>const& genomes, int const i, double const F) const;
+		void prepare(Population const& genomes);
+		void doMutation(Population const& genomes, int const i, double const F, Column donor) const;
 };
 
 class Best2MutationManager: public MutationManager {
 	private:
-		Solution const* best;
+		int best;
 	public:
 		Best2MutationManager(ConstraintHandler* const ch):MutationManager(ch){};
-		void prepare(std::vector<Solution*>const& genomes);
-		Solution* doMutation(std::vector<Solution*>const& genomes, int const i, double const F) const;
+		void prepare(Population const& genomes);
+		void doMutation(Population const& genomes, int const i, double const F, Column donor) const;
 };
 
 class Rand2MutationManager: public MutationManager {
 	public:
 		Rand2MutationManager(ConstraintHandler* const ch):MutationManager(ch){};
-		Solution* doMutation(std::vector<Solution*>const& genomes, int const i, double const F) const;
+		void doMutation(Population const& genomes, int const i, double const F, Column donor) const;
 };
 
 class Rand2DirMutationManager : public MutationManager {
 	public:
 		Rand2DirMutationManager(ConstraintHandler* const ch):MutationManager(ch){};
-		Solution* doMutation(std::vector<Solution*>const& genomes, int const i, double const F) const;
+		void doMutation(Population const& genomes, int const i, double const F, Column donor) const;
 };
 
 class NSDEMutationManager : public MutationManager {
 	public:
 		NSDEMutationManager(ConstraintHandler* const ch):MutationManager(ch){};
-		Solution* doMutation(std::vector<Solution*>const& genomes, int const i, double const F) const;
+		void doMutation(Population const& genomes, int const i, double const F, Column donor) const;
 };
 
 class TrigonometricMutationManager : public MutationManager {
 	private:
 		double const gamma;
-		Solution* trigonometricMutation(std::vector<Solution*>const& genomes, int const i, double const F) const;
-		Solution* rand1Mutation(std::vector<Solution*>const& genomes, int const i, double const F) const;
+		mutable ArrayXd base; // Reused buffer for the base vector of trigonometric mutation
+		void trigonometricMutation(Population const& genomes, int const i, double const F, Column donor) const;
+		void rand1Mutation(Population const& genomes, int const i, double const F, Column donor) const;
 	public:
 		TrigonometricMutationManager(ConstraintHandler* const ch): MutationManager(ch), gamma(0.05){};
-		Solution* doMutation(std::vector<Solution*>const& genomes, int const i, double const F) const;
+		void prepare(Population const& genomes);
+		void doMutation(Population const& genomes, int const i, double const F, Column donor) const;
 };
 
 class TwoOpt1MutationManager : public MutationManager {
 	public:
 		TwoOpt1MutationManager(ConstraintHandler* const ch): MutationManager(ch) {};
-		Solution* doMutation(std::vector<Solution*>const& genomes, int const i, double const F) const;
+		void doMutation(Population const& genomes, int const i, double const F, Column donor) const;
 };
 
 class TwoOpt2MutationManager : public MutationManager {
 	public:
 		TwoOpt2MutationManager(ConstraintHandler* const ch): MutationManager(ch){};
-		Solution* doMutation(std::vector<Solution*>const& genomes, int const i, double const F) const;
+		void doMutation(Population const& genomes, int const i, double const F, Column donor) const;
 };
 
 class ProximityMutationManager : public MutationManager {
 	private:
-		ArrayXXd Rp;
+		ArrayXXd positions; // Population as of the last prepare(), to detect replaced individuals
+		MatrixXd centered; // positions minus a reference point, improves the accuracy of the Gram identity
+		ArrayXd center;
+		ArrayXd squaredNorms;
+		MatrixXd gram;
+		ArrayXXd Rd; // Pairwise distances
+		ArrayXXd Rp; // Column i holds the selection weights of all individuals with respect to individual i
+		ArrayXd sums; // Of the columns of Rd
+		MatrixXd changed; // The centered columns of the replaced individuals
+		std::vector<int> replaced;
+		mutable FenwickSampler sampler; // Roulette over the proximities to individual i
+		void computeDistances();
+		void updateDistances();
+		bool offCenter() const;
 	public:
 		ProximityMutationManager(ConstraintHandler* const ch): MutationManager(ch){};
-		void prepare(std::vector<Solution*>const& genomes);
-		Solution* doMutation(std::vector<Solution*>const& genomes, int const i, double const F) const;
+		void prepare(Population const& genomes);
+		void doMutation(Population const& genomes, int const i, double const F, Column donor) const;
 };
 
 class RankingMutationManager : public MutationManager {
 	private:
-		std::vector<Solution*> sorted;
-		std::map<Solution*, double> probability;
-		Solution* pickRanked(std::vector<Solution*> & possibilities) const;
+		std::vector<int> sorted;
+		ArrayXd probability;
+		int pickRanked(IndexSampler& sampler) const;
 	public:
 		RankingMutationManager(ConstraintHandler* const ch): MutationManager(ch){};
-		void prepare(std::vector<Solution*>const& genomes);
-		Solution* doMutation(std::vector<Solution*>const& genomes, int const i, double const F) const;
+		void prepare(Population const& genomes);
+		void doMutation(Population const& genomes, int const i, double const F, Column donor) const;
 };
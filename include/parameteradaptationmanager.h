@@ -1,10 +1,13 @@
 #pragma once
-#include "solution.h"
+#include "population.h"
 #include "params.h"
+#include "buckets.h"
 
 using Eigen::ArrayXi;
 using Eigen::MatrixXd;
 
+class Checkpoint;
+
 class ParameterAdaptationManager {
 protected:
 	int const popSize;
@@ -14,7 +17,13 @@ public:
 	ParameterAdaptationManager(int const popSize, int const K); 
 	virtual ~ParameterAdaptationManager(){};
 	virtual void nextParameters(ArrayXd& Fs, ArrayXd& Crs, ArrayXi const& assignment)=0; 
+	virtual void nextParameters(int const config, double& F, double& Cr)=0; // A single draw
 	virtual void update(ArrayXd const& trialF)=0;
+	// For single draws: the improvements of a batch of trials, with the parameters they were created with
+	virtual void update(ArrayXd const& improvement, ArrayXd const& Fs, ArrayXd const& Crs, ArrayXi const& assignment)=0;
+	// The adaptation state between two generations
+	virtual void save(Checkpoint& /*checkpoint*/) const {};
+	virtual void restore(Checkpoint& /*checkpoint*/){};
 };
 
 class SHADEManager : public ParameterAdaptationManager {
@@ -26,14 +35,19 @@ class SHADEManager : public ParameterAdaptationManager {
 		MatrixXd MCr;
 		MatrixXd MF;
 		ArrayXi k; 
+		Buckets successes; // The successful trials of each configuration
+		ArrayXd SF, SCr, improvements; // Of the successful trials of one configuration, reused between updates
 
-		double weightedLehmerMean(ArrayXd const& x, ArrayXd const& w) const;
-		double weightedMean(ArrayXd const& x, ArrayXd const& w) const;
-		ArrayXd w(ArrayXd const& delta) const;
+		double weightedLehmerMean(ConstColumn const& x, ConstColumn const& w) const;
+		double weightedMean(ConstColumn const& x, ConstColumn const& w) const;
 	public:
 		SHADEManager(int const popSize, int const K);
 		void nextParameters(ArrayXd& Fs, ArrayXd& Crs, ArrayXi const& assignment); 
+		void nextParameters(int const config, double& F, double& Cr);
 		void update(ArrayXd const& improvement);
+		void update(ArrayXd const& improvement, ArrayXd const& Fs, ArrayXd const& Crs, ArrayXi const& assignment);
+		void save(Checkpoint& checkpoint) const; // The memories and their next entries
+		void restore(Checkpoint& checkpoint);
 };
 
 class ConstantParameterManager : public ParameterAdaptationManager {
@@ -43,5 +57,7 @@ class ConstantParameterManager : public ParameterAdaptationManager {
 	public:
 		ConstantParameterManager(int const popSize, int const K);
 		void nextParameters(ArrayXd& Fs, ArrayXd& Crs, ArrayXi const& assignment); 
+		void nextParameters(int const config, double& F, double& Cr);
 		void update(ArrayXd const& improvement);
+		void update(ArrayXd const& improvement, ArrayXd const& Fs, ArrayXd const& Crs, ArrayXi const& assignment);
 };
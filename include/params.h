@@ -17,6 +17,9 @@ namespace params {
 	extern bool log_repairs;
 	extern int log_repairs_interval;
 	extern std::string extra_data_path;
+	extern int log_buffer; // KiB per log file
+	extern std::string log_policy; // On a full buffer
+	extern std::string log_format;
 	extern Eigen::IOFormat const vecFmt; 
 
 	// DE
@@ -25,6 +28,19 @@ namespace params {
 	extern double popsize_multiplier;
 	extern double convergence_delta;
 	extern bool restart_on_convergence;
+	extern int threads;
+	extern bool asynchronous;
+
+	// Checkpoints
+	extern int checkpoint_interval; // Evaluations between two checkpoints of a run, 0 disables them
+	extern std::string checkpoint_path;
+	extern bool resume; // From the checkpoints of an interrupted campaign
+
+	// Island model
+	extern int islands;
+	extern std::string topology;
+	extern int migration_interval;
+	extern int migration_size;
 
 	extern double CO_omega;
 
@@ -0,0 +1,43 @@
+#pragma once
+#include <vector>
+#include "Eigen/Dense"
+#include "coco.h"
+
+using Eigen::ArrayXd;
+using Eigen::ArrayXXd;
+
+class Checkpoint;
+
+typedef Eigen::Ref<ArrayXd> Column; // Lightweight (non-owning) views on a single position
+typedef Eigen::Ref<ArrayXd const> ConstColumn;
+
+// Contiguous population store: one D x NP column-major matrix holding all positions,
+// plus a flat fitness array and an evaluated bitmap. Individual i is column i.
+class Population {
+	private:
+		ArrayXXd x;
+		ArrayXd fitness;
+		std::vector<bool> evaluated;
+	public:
+		Population(){};
+		Population(int const D, int const size);
+		void resize(int const D, int const size);
+		int size() const;
+		int dimension() const;
+		ArrayXXd const& X() const;
+		ArrayXXd::ConstColXpr X(int const i) const;
+		ArrayXXd::ColXpr modifyX(int const i); // Writable view on position i, marks it as not evaluated
+		void setX(int const i, ConstColumn const& x);
+		ArrayXd const& getFitness() const;
+		double getFitness(int const i) const;
+		void setFitness(int const i, double const f);
+		bool isEvaluated(int const i) const;
+		double evaluate(int const i, coco_problem_t* const problem);
+		void evaluate(coco_problem_t* const problem); // Evaluate all pending individuals, one COCO batch per run of adjacent columns
+		void compute(coco_problem_t* const problem); // As evaluate(), but COCO records nothing, see commit()
+		void commit(int const i, coco_problem_t* const problem, double const f); // Record a value computed on problem
+		void randomize(int const i, ArrayXd const& lowerBounds, ArrayXd const& upperBounds);
+		void swap(int const i, Population& other); // Exchange individual i with that of another population
+		void save(Checkpoint& checkpoint) const;
+		void restore(Checkpoint& checkpoint); // Resized to the saved population
+};
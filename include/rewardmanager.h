@@ -4,59 +4,66 @@
 #include <string>
 #include <vector>
 #include "Eigen/Dense"
+#include "buckets.h"
 
 using Eigen::ArrayXd;
 using Eigen::ArrayXi;
 
 class RewardManager {
+	private:
+		// Reused by every getReward(), which therefore does not allocate
+		Buckets groups;
+		ArrayXd values; // The credits of one group
+		ArrayXi order; // The individuals sorted on their credit, by ranks()
+		ArrayXd scores;
+		ArrayXd const& gather(ArrayXd const& credits, Indices const group);
 	protected:
-		ArrayXd average(std::vector<std::vector<double>>const& deltas) const;
-		ArrayXd extreme(std::vector<std::vector<double>>const& deltas) const;
-		ArrayXd normalized(ArrayXd const& x) const;
-		ArrayXd ranks(ArrayXd const& x) const;
-		std::vector<std::vector<double>> group(ArrayXd const& improvements, 
-				ArrayXi const& assignment) const;
+		// The reward of each configuration over its positive credits, as grouped by group()
+		void average(ArrayXd const& credits, Buckets const& groups, ArrayXd& reward);
+		void extreme(ArrayXd const& credits, Buckets const& groups, ArrayXd& reward) const;
+		void normalize(ArrayXd& x) const;
+		ArrayXd const& ranks(ArrayXd const& x);
+		Buckets const& group(ArrayXd const& credits, ArrayXi const& assignment);
 		int const K;
 	public:
 		static std::function<RewardManager*(int const)> create(std::string const id);
 		RewardManager(int const K);
 		virtual ~RewardManager (){};
-		virtual ArrayXd getReward(ArrayXd const& improvements, 
-				ArrayXi const& assignment) const=0;
+		virtual void getReward(ArrayXd const& improvements, ArrayXi const& assignment, ArrayXd& reward)=0;
 };
 
 class AverageNormalizedReward : public RewardManager {
 	public:
 		AverageNormalizedReward(int const K): RewardManager(K){};
-		ArrayXd getReward(ArrayXd const& improvements, ArrayXi const& assignment) const;
+		void getReward(ArrayXd const& improvements, ArrayXi const& assignment, ArrayXd& reward);
 };
 
 class AverageReward : public RewardManager {
 	public:
 		AverageReward(int const K): RewardManager(K){};
-		ArrayXd getReward(ArrayXd const& improvements, ArrayXi const& assignment) const;
+		void getReward(ArrayXd const& improvements, ArrayXi const& assignment, ArrayXd& reward);
 };
 
 class ExtremeNormalizedReward : public RewardManager {
 	public:
 		ExtremeNormalizedReward(int const K): RewardManager(K){};
-		ArrayXd getReward(ArrayXd const& improvements, ArrayXi const& assignment) const;
+		void getReward(ArrayXd const& improvements, ArrayXi const& assignment, ArrayXd& reward);
 };
 
 class ExtremeReward : public RewardManager {
 	public:
 		ExtremeReward(int const K): RewardManager(K){};
-		ArrayXd getReward(ArrayXd const& improvements, ArrayXi const& assignment) const;
+		void getReward(ArrayXd const& improvements, ArrayXi const& assignment, ArrayXd& reward);
 };
 
 class ExtremeRankReward : public RewardManager {
 	public:
 		ExtremeRankReward(int const K): RewardManager(K){};
-		ArrayXd getReward(ArrayXd const& improvements, ArrayXi const& assignment) const;
+		void getReward(ArrayXd const& improvements, ArrayXi const& assignment, ArrayXd& reward);
 };
 
 class AverageRankReward : public RewardManager {
 	public:
 		AverageRankReward(int const K): RewardManager(K){};
-		ArrayXd getReward(ArrayXd const& improvements, ArrayXi const& assignment) const;
+		void getReward(ArrayXd const& improvements, ArrayXi const& assignment, ArrayXd& reward);
 };
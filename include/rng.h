@@ -1,18 +1,97 @@
 #pragma once
+#include <cstdint>
+#include <functional>
 #include <random>
+#include <string>
+#include <vector>
 #include <algorithm>
+#include "Eigen/Dense"
+
+class Checkpoint;
+
+// Source of uniformly distributed 64-bit words. Engines are only asked for words in bulk, so the cost
+// of the virtual call is amortized over a whole buffer.
+class RandomEngine {
+	public:
+		static std::function<RandomEngine* (uint64_t const)> create(std::string const id);
+		virtual ~RandomEngine(){};
+		virtual void fill(uint64_t* const words, int const n)=0;
+		virtual void save(Checkpoint& checkpoint) const=0;
+		virtual void restore(Checkpoint& checkpoint)=0;
+};
+
+class MersenneTwisterEngine : public RandomEngine {
+	private:
+		std::mt19937_64 mt;
+	public:
+		MersenneTwisterEngine(uint64_t const seed);
+		void fill(uint64_t* const words, int const n);
+		void save(Checkpoint& checkpoint) const;
+		void restore(Checkpoint& checkpoint);
+};
+
+class Xoshiro256Engine : public RandomEngine { // xoshiro256++, Blackman & Vigna
+	private:
+		uint64_t s[4];
+	public:
+		Xoshiro256Engine(uint64_t const seed);
+		void fill(uint64_t* const words, int const n);
+		void save(Checkpoint& checkpoint) const;
+		void restore(Checkpoint& checkpoint);
+};
+
+class PhiloxEngine : public RandomEngine { // Philox4x32-10, Salmon et al. (Random123)
+	private:
+		uint32_t counter[4];
+		uint32_t key[2];
+	public:
+		PhiloxEngine(uint64_t const seed);
+		void fill(uint64_t* const words, int const n);
+		void save(Checkpoint& checkpoint) const;
+		void restore(Checkpoint& checkpoint);
+};
 
 class RNG {
 	private:
-		std::random_device dev;
-		std::mt19937 rng;
+		std::string engineID;
+		uint64_t engineSeed;
+		RandomEngine* engine;
+		std::vector<uint64_t> buffer;
+		unsigned int position;
+		uint64_t word();
+		int available(int const n); // How many of n words can be taken from the buffer at once, refilling it if empty
+		double uniform(); // [0,1)
+		double uniformPositive(); // (0,1]
 	public:
-		RNG() : rng(dev()){} 
+		RNG();
+		~RNG();
+		void setEngine(std::string const id); // Restarts the stream from the current seed
+		std::string const& getEngine() const;
+		void seed(uint64_t const s);
+		void seed(); // From std::random_device
+		void save(Checkpoint& checkpoint) const; // The engine, its state and the buffered words
+		void restore(Checkpoint& checkpoint);
+		uint64_t randWord(); // All 64 bits of the next word, e.g. to seed another stream
 		double randDouble(double const start, double const end);
 		int randInt(int const start, int const end);
 		double normalDouble(double const mean, double const stdDev);
 		double cauchyDouble(double const a, double const b);
-		void seed(double const s);
+		// Bulk draws, filling every coefficient of x
+		void fillUniform(Eigen::Ref<Eigen::ArrayXXd> x, double const start, double const end);
+		void fillNormal(Eigen::Ref<Eigen::ArrayXXd> x, double const mean, double const stdDev);
+		void fillCauchy(Eigen::Ref<Eigen::ArrayXXd> x, double const a, double const b);
 };
 
-extern RNG rng;
+inline uint64_t RNG::word(){
+	if (position == buffer.size()){
+		engine->fill(buffer.data(), buffer.size());
+		position = 0;
+	}
+	return buffer[position++];
+}
+
+inline uint64_t RNG::randWord(){
+	return word();
+}
+
+extern thread_local RNG rng; // Every thread has its own stream
@@ -1,8 +1,11 @@
 #pragma once
 #include <string>
 #include <vector>
-#include <map>
+#include <tuple>
 #include "Eigen/Dense"
+#include "util.h"
+#include "trialkernel.h"
+#include "buckets.h"
 
 using Eigen::ArrayXd;
 using Eigen::ArrayXi;
@@ -20,30 +23,44 @@ class ParameterAdaptationManager;
 class MutationManager;
 class CrossoverManager;
 class ConstraintHandler;
-class Solution;
+class Population;
+class Checkpoint;
 
 class StrategyAdaptationManager {
 	public:
 		static std::function<StrategyAdaptationManager* (StrategyAdaptationConfiguration const, ConstraintHandler *const, 
-				std::vector<Solution*>const&)> create(std::string const id);
+				Population const&)> create(std::string const id);
 
 		StrategyAdaptationManager(StrategyAdaptationConfiguration const config, ConstraintHandler *const ch, 
-				std::vector<Solution*>const& population);
+				Population const& population);
 		virtual ~StrategyAdaptationManager();
-		virtual void next(std::vector<Solution*>const& population, std::map<MutationManager*, std::vector<int>>& mutation, 
-				std::map<CrossoverManager*, std::vector<int>>& crossover, ArrayXd& Fs, ArrayXd& Crs)=0;
-		virtual void update(std::vector<Solution*>const& trials)=0;
+		virtual void next(Population const& population, Buckets& assignment, 
+				ArrayXd& Fs, ArrayXd& Crs)=0;
+		virtual void update(Population const& trials)=0;
+
+		// Steady-state interface, one target at a time: next() picks the configuration, F and Cr of the trial of
+		// target i, update() reports its result. Results are gathered in a window of popSize, after which the
+		// adaptation is updated as after one generation. Distances are taken to the given population mean.
+		int next(Population const& population, ArrayXd const& mean, int const i, double& F, double& Cr);
+		void update(Population const& trials, ArrayXd const& mean, int const i);
+
 		std::vector<MutationManager*> getMutationManagers() const;
 		std::vector<CrossoverManager*> getCrossoverManagers() const;
-		ArrayXi getLastActivations() const;
-		ArrayXd getDistancesToMeanPosition() const;
+		std::vector<std::tuple<MutationManager*, CrossoverManager*>> const& getConfigurations() const;
+		std::vector<TrialKernel> const& getTrialKernels() const;
+		void addLastActivations(ArrayXi& activations) const; // Counts the configurations of the last generation
+		ArrayXd const& getDistancesToMeanPosition() const;
 		std::vector<std::string> getConfigurationIDs() const;
+		// The adaptation state between two generations of the generational interface
+		virtual void save(Checkpoint& checkpoint) const;
+		virtual void restore(Checkpoint& checkpoint);
 		int const K;
 	protected:
 		StrategyAdaptationConfiguration const config;
 		std::vector<MutationManager*> mutationManagers; 
 		std::vector<CrossoverManager*> crossoverManagers; 
 		std::vector<std::tuple<MutationManager*, CrossoverManager*>> configurations;
+		std::vector<TrialKernel> trialKernels; // Dispatch table: the specialized kernel of each configuration
 		std::vector<std::string> configurationIDs;
 		int const popSize;
 		int const D;
@@ -51,49 +68,68 @@ class StrategyAdaptationManager {
 		ArrayXd previousFitness; 
 		ArrayXd previousMean;
 		ArrayXd previousDistances; // Distances of all K configs
-		std::vector<int> previousStrategies;
-		void assign(std::map<MutationManager*, std::vector<int>>& mutation, 
-				std::map<CrossoverManager*, std::vector<int>>& crossover, std::vector<int> const& assignment);
-		ArrayXd getMean(std::vector<Solution*>const& population) const;
-		ArrayXd getDistances(std::vector<Solution*>const& population, ArrayXd const& mean) const;
+		ArrayXi previousStrategies;
+		ArrayXd fitnessDeltas, currentDistances, credit, reward; // Of the last generation, reused by update()
+		ArrayXd targetFs, targetCrs; // Parameters of the pending trial of each target
+		ArrayXd windowDeltas, windowPreviousDistances, windowCurrentDistances, windowFs, windowCrs;
+		ArrayXi windowStrategies;
+		int windowSize;
+		virtual int sampleStrategy()=0;
+		virtual void adapt(ArrayXd const& fitnessDeltas, ArrayXd const& previousDistances, 
+				ArrayXd const& currentDistances, ArrayXi const& strategies, ArrayXd const& Fs, ArrayXd const& Crs)=0;
+		void assign(Buckets& assignment, ArrayXi const& strategies) const;
+		void computeMean(Population const& population, ArrayXd& mean) const;
+		void computeDistances(Population const& population, ArrayXd const& mean, ArrayXd& distances) const;
 };
 
 class AdaptiveStrategyManager : public StrategyAdaptationManager {
 	private:
 		CreditManager const* const creditManager;
-		RewardManager const* const rewardManager;
+		RewardManager* const rewardManager;
 		QualityManager const* const qualityManager;
 		ProbabilityManager const* const probabilityManager;
 		ArrayXd p; 
 		ArrayXd q; 
 		ArrayXd used;	
+		AliasTable strategySampler; // Roulette over p
+		int sampleStrategy();
+		void adapt(ArrayXd const& fitnessDeltas, ArrayXd const& previousDistances, ArrayXd const& currentDistances, 
+				ArrayXi const& strategies, ArrayXd const& Fs, ArrayXd const& Crs);
 	public:
 		AdaptiveStrategyManager(StrategyAdaptationConfiguration const config, ConstraintHandler* const ch, 
-				std::vector<Solution*>const& population);
+				Population const& population);
 		~AdaptiveStrategyManager();
-		void next(std::vector<Solution*>const & population, std::map<MutationManager*, std::vector<int>>& mutation, 
-				std::map<CrossoverManager*, std::vector<int>>& crossover, 
+		void next(Population const& population, Buckets& assignment, 
 				ArrayXd& Fs, ArrayXd& Crs);
-		void update(std::vector<Solution*>const& trials);
+		void update(Population const& trials);
+		void save(Checkpoint& checkpoint) const;
+		void restore(Checkpoint& checkpoint);
 };
 
 class RandomStrategyManager : public StrategyAdaptationManager {
+	private:
+		int sampleStrategy();
+		void adapt(ArrayXd const& fitnessDeltas, ArrayXd const& previousDistances, ArrayXd const& currentDistances, 
+				ArrayXi const& strategies, ArrayXd const& Fs, ArrayXd const& Crs);
 	public:
 		RandomStrategyManager(StrategyAdaptationConfiguration const config, ConstraintHandler* const ch, 
-				std::vector<Solution*>const& population);
-		void next(std::vector<Solution*>const & population, std::map<MutationManager*, std::vector<int>>& mutation, 
-				std::map<CrossoverManager*, std::vector<int>>& crossover, ArrayXd& Fs, ArrayXd& Crs);
-		void update(std::vector<Solution*>const& trials);
+				Population const& population);
+		void next(Population const& population, Buckets& assignment, 
+				ArrayXd& Fs, ArrayXd& Crs);
+		void update(Population const& trials);
 };
 
 class ConstantStrategyManager : public StrategyAdaptationManager {
 	private:
 		CreditManager const* const creditManager;
+		int sampleStrategy();
+		void adapt(ArrayXd const& fitnessDeltas, ArrayXd const& previousDistances, ArrayXd const& currentDistances, 
+				ArrayXi const& strategies, ArrayXd const& Fs, ArrayXd const& Crs);
 	public:
 		ConstantStrategyManager(StrategyAdaptationConfiguration const config, ConstraintHandler* const ch, 
-				std::vector<Solution*>const& population);
+				Population const& population);
 		~ConstantStrategyManager();
-		void next(std::vector<Solution*>const & population, std::map<MutationManager*, std::vector<int>>& mutation, 
-				std::map<CrossoverManager*, std::vector<int>>& crossover, ArrayXd& Fs, ArrayXd& Crs);
-		void update(std::vector<Solution*>const& trials);
+		void next(Population const& population, Buckets& assignment, 
+				ArrayXd& Fs, ArrayXd& Crs);
+		void update(Population const& trials);
 };
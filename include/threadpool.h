@@ -0,0 +1,50 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads executing parallel loops. The calling thread takes part as thread 0,
+// so a pool of size N occupies N cores.
+class ThreadPool {
+	private:
+		std::vector<std::thread> workers;
+		std::mutex mutex;
+		std::condition_variable started, finished;
+		std::function<void(int, int)> task;
+		int n;
+		std::atomic<int> next; // Next loop index to be claimed
+		int busy; // Workers still working on the current loop
+		unsigned int round; // Incremented for every loop, wakes up the workers
+		bool stopping;
+		void work(int const thread);
+		void claim(int const thread);
+	public:
+		ThreadPool(int const size);
+		~ThreadPool();
+		int size() const;
+		// Calls task(thread, i) for every i in [0,n) and returns when all calls have finished
+		void run(int const n, std::function<void(int, int)> const& task);
+};
+
+// Worker threads calling task(thread, i) for submitted indices, one index at a time and in any order. Finished
+// indices are handed back in completion order, so the caller can act on each as soon as it is done.
+class AsyncExecutor {
+	private:
+		std::vector<std::thread> workers;
+		std::mutex mutex;
+		std::condition_variable submitted, finished;
+		std::function<void(int, int)> const task;
+		std::deque<int> pending, done;
+		bool stopping;
+		void work(int const thread);
+	public:
+		AsyncExecutor(int const size, std::function<void(int, int)> const& task);
+		~AsyncExecutor();
+		int size() const;
+		void submit(int const i);
+		int wait(); // Blocks until a submitted index is done, and returns it
+};
@@ -0,0 +1,20 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "population.h"
+#include "buckets.h"
+
+using Eigen::ArrayXXd;
+
+class MutationManager;
+class CrossoverManager;
+
+// Generates the (unevaluated) trials of the given individuals with a single mutation/crossover configuration.
+// Each configuration has its own instantiation in which both operators are called non-virtually.
+// Donor i is written to column i of donors, except with binomial crossover, which crosses each donor over as
+// soon as it is generated.
+typedef void (*TrialKernel)(MutationManager& mutation, CrossoverManager const& crossover, 
+		Population const& genomes, Indices const indices, ArrayXd const& Fs, ArrayXd const& Crs, 
+		ArrayXXd& donors, Population& trials);
+
+TrialKernel getTrialKernel(std::string const mutation, std::string const crossover);
@@ -1,54 +1,132 @@
 #pragma once
+#include <array>
+#include <cassert>
+#include <numeric>
 #include "rng.h"
-#include "solution.h"
+#include "population.h"
 
-double distance(Solution const* const s1, Solution const* const s2);
-double distance(ArrayXd const& s1, ArrayXd const& s2);
+double distance(ConstColumn const& s1, ConstColumn const& s2);
 std::vector<int> range(int const size);
-Solution* getBest(std::vector<Solution*>const& genomes);
-Solution* getWorst(std::vector<Solution*>const& genomes);
-std::vector<Solution*> sortOnFitness(std::vector<Solution*> genomes);
-
-template <typename T>
-std::vector<T> remove(std::vector<T> vec, int const i){
-	vec.erase(vec.begin()+i);
-	return vec;
-}
+int getBest(Population const& genomes);
+int getWorst(Population const& genomes);
+std::vector<int> sortOnFitness(Population const& genomes);
+void sortOnFitness(Population const& genomes, std::vector<int>& sorted); // Reuses the storage of sorted
+
+// Draws distinct indices from {0,...,n-1} without replacement, skipping excluded indices. Draws are mapped
+// onto the remaining indices directly, so no candidate list is built: O(k^2) for k draws, independent of n.
+class IndexSampler {
+	private:
+		static int const capacity = 8;
+		int const n;
+		int nExcluded;
+		std::array<int, capacity> excluded; // Sorted ascending
+	public:
+		IndexSampler(int const n, int const exclude) : n(n), nExcluded(0){
+			this->exclude(exclude);
+		}
+
+		int remaining() const {
+			return n - nExcluded;
+		}
+
+		int nth(int const r) const { // The r-th remaining index
+			int index = r;
+			for (int j = 0; j < nExcluded && excluded[j] <= index; j++)
+				index++;
+			return index;
+		}
+
+		void exclude(int const index){
+			assert(nExcluded < capacity);
+			int j = nExcluded++;
+			for (; j > 0 && excluded[j-1] > index; j--)
+				excluded[j] = excluded[j-1];
+			excluded[j] = index;
+		}
 
-template<typename T>
-std::vector<T> pickRandom(std::vector<T> possibilities, int const n, bool const replace){
-	std::vector<T> picked;
-	picked.reserve(n);
-	for (int i = 0; i < n; i++){
-		int const r = rng.randInt(0,possibilities.size()-1);
-		T const x = possibilities[r];
-		if (!replace)
-			possibilities.erase(possibilities.begin() + r);
-		picked.push_back(x);
-	}
+		int next(){ // Uniformly random remaining index, which is then excluded
+			int const index = nth(rng.randInt(0, remaining()-1));
+			exclude(index);
+			return index;
+		}
+};
+
+// Picks k distinct indices from {0,...,n-1}, excluding i
+template<int k>
+std::array<int, k> pickRandom(int const n, int const i){
+	IndexSampler sampler(n, i);
+	std::array<int, k> picked;
+	for (int j = 0; j < k; j++)
+		picked[j] = sampler.next();
 	return picked;
 }
 
-template<typename T>
-std::vector<T> rouletteSelect(std::vector<T> possibilities, std::vector<double> prob, int const n, bool const replace){
-	std::vector<T> picked;
-	picked.reserve(n);
-	double totalProb = std::accumulate(prob.begin(), prob.end(), 0.);
-	for (int i = 0; i < n; i++){
-		double rand = rng.randDouble(0.,totalProb);
-		for (unsigned int j = 0; j < possibilities.size(); j++){
-			rand -= prob[j];
-			if (rand <= 0.){
-				T const t = possibilities[j];
-				if (!replace){
-					possibilities.erase(possibilities.begin() + j);
-					totalProb -= prob[j];
-					prob.erase(prob.begin() + j);
+// Roulette selection with replacement using Walker's alias method: O(n) construction, O(1) per draw.
+// The tables are reused, so rebuilding for a new set of weights does not allocate.
+class AliasTable {
+	private:
+		std::vector<double> prob;
+		std::vector<int> alias;
+		std::vector<int> small, large; // Work lists used during construction
+	public:
+		template<typename Derived>
+		void build(Eigen::DenseBase<Derived> const& weights){
+			int const n = weights.size();
+			double const total = weights.sum();
+			prob.resize(n);
+			alias.resize(n);
+			small.clear();
+			large.clear();
+
+			for (int i = 0; i < n; i++){
+				prob[i] = total > 0. ? weights(i) * n / total : 1.; // Uniform if there is no weight at all
+				(prob[i] < 1. ? small : large).push_back(i);
+			}
+
+			while (!small.empty() && !large.empty()){
+				int const s = small.back(), l = large.back();
+				small.pop_back();
+				alias[s] = l;
+				prob[l] -= 1. - prob[s];
+				if (prob[l] < 1.){
+					large.pop_back();
+					small.push_back(l);
 				}
-				picked.push_back(t);
-				break;
-			} 
+			}
+
+			for (int const i : large) prob[i] = 1.;
+			for (int const i : small) prob[i] = 1.; // Leftovers due to rounding errors
 		}
-	}
-	return picked;
-}
+		int sample() const;
+};
+
+// Roulette selection without replacement using a Fenwick (binary indexed) tree over the weights:
+// O(n) construction, O(log n) per draw and removal. Buffers are reused between builds.
+class FenwickSampler {
+	private:
+		int n;
+		int top; // Largest power of two <= n
+		std::vector<double> tree; // 1-based partial sums
+		std::vector<double> weights;
+		int find(double const value) const;
+	public:
+		FenwickSampler(): n(0), top(0){};
+		template<typename Derived>
+		void build(Eigen::DenseBase<Derived> const& w){
+			n = w.size();
+			weights.resize(n);
+			tree.assign(n+1, 0.);
+			for (int i = 0; i < n; i++)
+				tree[i+1] = weights[i] = w(i);
+			for (int i = 1; i <= n; i++){
+				int const parent = i + (i & -i);
+				if (parent <= n)
+					tree[parent] += tree[i];
+			}
+			for (top = 1; top * 2 <= n; top *= 2);
+		}
+		double total() const;
+		int sample() const;
+		void remove(int const i);
+		int next(); // Sample and remove
+};
@@ -0,0 +1,384 @@
+#include <algorithm>
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <dirent.h>
+#include <sys/stat.h>
+#include "campaign.h"
+#include "checkpoint.h"
+#include "params.h"
+
+static std::vector<std::string> readLines(std::string const path){
+	std::ifstream in(path);
+	std::vector<std::string> lines;
+	for (std::string line; std::getline(in, line);)
+		lines.push_back(line);
+	return lines;
+}
+
+static std::vector<std::string> listFiles(std::string const folder, std::string const extension){
+	std::vector<std::string> files;
+	if (DIR* const dir = opendir(folder.c_str())){
+		while (dirent const* const entry = readdir(dir)){
+			std::string const name = entry->d_name;
+			if (name.size() > extension.size() && name.compare(name.size()-extension.size(), extension.size(), extension) == 0)
+				files.push_back(name);
+		}
+		closedir(dir);
+	}
+	std::sort(files.begin(), files.end());
+	return files;
+}
+
+// The result folders that COCO created for the attempts of a task next to the given one: the ID of the task,
+// made unique by a suffix -001, -002...
+static std::vector<std::string> listAttempts(std::string const folder, std::string const id){
+	std::string const parent = folder.substr(0, folder.rfind('/'));
+	std::vector<std::string> attempts;
+	if (DIR* const dir = opendir(parent.c_str())){
+		while (dirent const* const entry = readdir(dir)){
+			std::string const name = entry->d_name;
+			if (name == id || (name.size() == id.size() + 4 && name.compare(0, id.size() + 1, id + "-") == 0
+						&& name.find_first_not_of("0123456789", id.size() + 1) == std::string::npos))
+				attempts.push_back(parent + "/" + name);
+		}
+		closedir(dir);
+	}
+	return attempts;
+}
+
+static void appendFile(std::ofstream& out, std::string const path){
+	std::ifstream in(path, std::ios::binary);
+	if (in.is_open())
+		out << in.rdbuf();
+}
+
+// The tasks are those of the suite, in the order in which a serial experiment would visit them
+Campaign::Campaign(std::string const suiteName, std::string const suiteInstances, std::string const suiteOptions, 
+		std::string const observerName, std::string const id)
+	:suiteName(suiteName), observerName(observerName), id(id){
+	if (observerName != "bbob" && observerName != "hits")
+		throw std::invalid_argument("no such observer: " + observerName);
+	coco_suite_t* const suite = coco_suite(suiteName.c_str(), suiteInstances.c_str(), suiteOptions.c_str());
+	for (size_t index = 0; index < coco_suite_get_number_of_problems(suite); index++){
+		size_t f, d, i;
+		coco_suite_decode_problem_index(suite, index, &f, &d, &i);
+		CampaignTask task;
+		task.function = coco_suite_get_function_from_function_index(suite, f);
+		task.dimension = coco_suite_get_dimension_from_dimension_index(suite, d);
+		task.instance = coco_suite_get_instance_from_instance_index(suite, i);
+		if (task.function == 0 || task.dimension == 0 || task.instance == 0) 
+			continue; // Excluded by the suite options
+		task.index = tasks.size();
+		task.id = id + "-part" + std::to_string(task.index);
+		task.cost = 1;
+		task.checkpoint = params::checkpoint_interval > 0 ? params::checkpoint_path + "/" + task.id : "";
+		task.resumed = nullptr;
+		tasks.push_back(task);
+	}
+	coco_suite_free(suite);
+}
+
+int Campaign::size() const {
+	return tasks.size();
+}
+
+void CampaignTask::save(coco_problem_t* const problem, std::function<void(Checkpoint&)> const& state) const{
+	Checkpoint c;
+	c.write(resultFolder);
+	Eigen::ArrayXd coco(coco_problem_save_state(problem, nullptr));
+	coco_problem_save_state(problem, coco.data());
+	c.write(coco);
+	state(c);
+	c.save(checkpoint + ".ckpt");
+}
+
+// COCO keeps global state, such as the buffer of coco_strdupf, which suites, observers and problems write while
+// they are created and freed. Tasks running in parallel only do so under this lock.
+static std::mutex cocoMutex;
+
+// A task resumed from a checkpoint starts from the COCO output of the interrupted attempt up to the checkpoint,
+// in a new result folder, and continues it (see coco_problem_restore_state). The checkpoint is moved over to
+// the new folder before the folders of earlier attempts are removed.
+void Campaign::runTask(CampaignTask& task, std::function<void(CampaignTask const&, coco_problem_t*)> const& solve){
+	if (params::resume && !task.checkpoint.empty()){
+		std::vector<std::string> const done = readLines(task.checkpoint + ".done");
+		if (!done.empty()){
+			task.resultFolder = done[0];
+			return;
+		}
+	}
+
+	std::unique_lock<std::mutex> lock(cocoMutex);
+	coco_suite_t* const suite = coco_suite(suiteName.c_str(), ("instances: " + std::to_string(task.instance)).c_str(), 
+			("dimensions: " + std::to_string(task.dimension) + " function_indices: " 
+			 + std::to_string(task.function)).c_str());
+	coco_observer_t* const observer = coco_observer(observerName.c_str(), ("result_folder: " + task.id).c_str());
+	task.resultFolder = coco_observer_get_result_folder(observer);
+	coco_problem_t* const problem = coco_suite_get_next_problem(suite, observer);
+
+	std::unique_ptr<Checkpoint> resumed;
+	std::string const checkpoint = task.checkpoint + ".ckpt";
+	if (params::resume && !task.checkpoint.empty() && std::ifstream(checkpoint).good()){
+		resumed.reset(new Checkpoint(checkpoint));
+		std::string previousFolder;
+		Eigen::ArrayXd state;
+		resumed->read(previousFolder);
+		resumed->read(state);
+		coco_problem_restore_state(problem, state.data());
+		carryOver(previousFolder, task.resultFolder, coco_problem_get_evaluations(problem));
+
+		Checkpoint moved;
+		moved.write(task.resultFolder);
+		moved.write(state);
+		moved.append(*resumed);
+		moved.save(checkpoint);
+	}
+	if (params::resume && !task.checkpoint.empty()) // Including attempts interrupted before their first checkpoint
+		for (std::string const& attempt : listAttempts(task.resultFolder, task.id))
+			if (attempt != task.resultFolder)
+				coco_remove_directory(attempt.c_str());
+	lock.unlock();
+
+	task.resumed = resumed.get();
+	solve(task, problem);
+	task.resumed = nullptr;
+
+	lock.lock();
+	coco_observer_free(observer);
+	coco_suite_free(suite);
+	lock.unlock();
+
+	if (!task.checkpoint.empty()){
+		{
+			std::ofstream out(task.checkpoint + ".done.tmp");
+			out << task.resultFolder << "\n";
+		}
+		std::rename((task.checkpoint + ".done.tmp").c_str(), (task.checkpoint + ".done").c_str());
+		std::remove(checkpoint.c_str());
+	}
+}
+
+// Copies the .dat, .tdat and .rdat files of a result folder with the output of a single bbob problem, without
+// the lines of the evaluations after the given one. The hits observer has no output before the problem is freed.
+void Campaign::carryOver(std::string const from, std::string const to, size_t const evaluations) const{
+	if (observerName == "hits")
+		return;
+	std::vector<std::string> const infoFiles = listFiles(from, ".info");
+	std::vector<std::string> const lines = infoFiles.size() == 1 ? 
+		readLines(from + "/" + infoFiles[0]) : std::vector<std::string>();
+	if (lines.size() < 3)
+		throw std::runtime_error("Unexpected COCO output in " + from);
+
+	std::string const data = lines[2].substr(0, lines[2].rfind(".dat", lines[2].find(',')));
+	mkdir((to + "/" + data.substr(0, data.find('/'))).c_str(), 0755);
+	for (char const* extension : {".dat", ".tdat", ".rdat"}){
+		std::ofstream out(to + "/" + data + extension, std::ios::binary);
+		for (std::string const& line : readLines(from + "/" + data + extension))
+			if (!line.empty() && (line[0] == '%' || std::stoull(line) <= evaluations))
+				out << line << "\n";
+	}
+}
+
+// Work-stealing executor for tasks of very different lengths. The tasks are dealt out longest first, each to
+// the worker with the least expected work so far. A worker runs the longest task of its own deque; when that is
+// empty, it steals the shortest task from the worker with the most expected work left.
+class TaskQueues {
+	private:
+		struct Deque {
+			std::mutex mutex;
+			std::deque<int> tasks; // Longest first
+			double remaining = 0; // Expected cost of the queued tasks
+		};
+		std::vector<CampaignTask> const& tasks;
+		std::vector<Deque> deques;
+		bool steal(int const worker, int& task);
+	public:
+		TaskQueues(std::vector<CampaignTask> const& tasks, int const workers);
+		bool next(int const worker, int& task); // False once all tasks have been claimed
+};
+
+TaskQueues::TaskQueues(std::vector<CampaignTask> const& tasks, int const workers)
+	:tasks(tasks), deques(workers){
+	std::vector<int> order(tasks.size());
+	for (size_t i = 0; i < order.size(); i++)
+		order[i] = i;
+	std::stable_sort(order.begin(), order.end(), [&tasks](int const a, int const b){
+		return tasks[a].cost > tasks[b].cost;
+	});
+	for (int const i : order){
+		Deque& d = *std::min_element(deques.begin(), deques.end(), [](Deque const& a, Deque const& b){
+			return a.remaining < b.remaining;
+		});
+		d.tasks.push_back(i);
+		d.remaining += tasks[i].cost;
+	}
+}
+
+bool TaskQueues::next(int const worker, int& task){
+	{
+		Deque& own = deques[worker];
+		std::lock_guard<std::mutex> lock(own.mutex);
+		if (!own.tasks.empty()){
+			task = own.tasks.front();
+			own.tasks.pop_front();
+			own.remaining -= tasks[task].cost;
+			return true;
+		}
+	}
+	return steal(worker, task);
+}
+
+bool TaskQueues::steal(int const worker, int& task){
+	// Nothing is queued after construction, so a thief can stop as soon as every deque is seen empty
+	while (true){
+		int victim = -1;
+		double most = 0;
+		for (size_t j = 0; j < deques.size(); j++){
+			if ((int)j == worker)
+				continue;
+			std::lock_guard<std::mutex> lock(deques[j].mutex);
+			if (!deques[j].tasks.empty() && (victim < 0 || deques[j].remaining > most)){
+				victim = j;
+				most = deques[j].remaining;
+			}
+		}
+		if (victim < 0)
+			return false;
+
+		Deque& d = deques[victim];
+		std::lock_guard<std::mutex> lock(d.mutex);
+		if (d.tasks.empty())
+			continue; // Emptied in the meantime, look again
+		task = d.tasks.back();
+		d.tasks.pop_back();
+		d.remaining -= tasks[task].cost;
+		return true;
+	}
+}
+
+void Campaign::run(int const jobs, std::function<double(CampaignTask const&)> const& cost, 
+		std::function<void(CampaignTask const&, coco_problem_t*)> const& solve){
+	for (CampaignTask& task : tasks)
+		task.cost = cost(task);
+
+	if (params::checkpoint_interval > 0)
+		mkdir(params::checkpoint_path.c_str(), 0755);
+
+	int const workers = std::max(1, std::min(jobs, size()));
+	TaskQueues queues(tasks, workers);
+	auto const work = [this, &queues, &solve](int const worker){
+		for (int i; queues.next(worker, i);)
+			runTask(tasks[i], solve);
+	};
+
+	std::vector<std::thread> threads;
+	for (int j = 1; j < workers; j++)
+		threads.emplace_back(work, j);
+	work(0);
+	for (std::thread& thread : threads)
+		thread.join();
+
+	mergeResults();
+	mergeExtraData();
+	for (CampaignTask const& task : tasks)
+		if (!task.checkpoint.empty())
+			std::remove((task.checkpoint + ".done").c_str());
+}
+
+// Every part folder holds one .info file with a single entry: a header line, a comment line and a line with
+// the path of the .dat file followed by the run summary. Parts of the same function share one .info file,
+// parts of the same function and dimension share their .dat, .tdat and .rdat files. As in a serial run,
+// file names end with the first instance of the campaign.
+void Campaign::mergeResults() const{
+	if (tasks.empty())
+		return;
+
+	// The observer chooses (and creates) a result folder that does not exist yet
+	coco_observer_t* const observer = coco_observer(observerName.c_str(), ("result_folder: " + id).c_str());
+	std::string const folder = coco_observer_get_result_folder(observer);
+	coco_observer_free(observer);
+
+	// The hits observer writes a single summary file per folder: one header, then a line per problem
+	if (observerName == "hits"){
+		std::ofstream out(folder + "/hits.txt");
+		for (CampaignTask const& task : tasks){
+			for (std::string const& line : readLines(task.resultFolder + "/hits.txt"))
+				if (line[0] != '%' || &task == &tasks[0])
+					out << line << "\n";
+			coco_remove_directory(task.resultFolder.c_str());
+		}
+		return;
+	}
+
+	std::string const suffix = "_i" + std::to_string(tasks[0].instance);
+	std::map<size_t, std::string> infoNames;
+	std::map<size_t, std::vector<std::string>> infoLines;
+	std::map<std::pair<size_t, size_t>, int> entries; // (function, dimension) -> its line in the .info file
+
+	for (CampaignTask const& task : tasks){
+		std::vector<std::string> const infoFiles = listFiles(task.resultFolder, ".info");
+		std::vector<std::string> const lines = infoFiles.size() == 1 ? 
+			readLines(task.resultFolder + "/" + infoFiles[0]) : std::vector<std::string>();
+		if (lines.size() < 3)
+			throw std::runtime_error("Unexpected COCO output in " + task.resultFolder);
+
+		size_t const comma = lines[2].find(',');
+		std::string const data = lines[2].substr(0, lines[2].rfind(".dat", comma)); // Without extension
+		std::string const merged = data.substr(0, data.rfind("_i")) + suffix;
+
+		std::pair<size_t, size_t> const key(task.function, task.dimension);
+		if (!entries.count(key)){
+			if (!infoNames.count(task.function))
+				infoNames[task.function] = infoFiles[0].substr(0, infoFiles[0].rfind("_i")) + suffix + ".info";
+			mkdir((folder + "/" + merged.substr(0, merged.find('/'))).c_str(), 0755);
+			infoLines[task.function].push_back(lines[0]);
+			infoLines[task.function].push_back(lines[1]);
+			infoLines[task.function].push_back(merged + ".dat");
+			entries[key] = infoLines[task.function].size()-1;
+		}
+		if (comma != std::string::npos)
+			infoLines[task.function][entries[key]] += lines[2].substr(comma);
+
+		for (char const* extension : {".dat", ".tdat", ".rdat"}){
+			std::ofstream out(folder + "/" + merged + extension, std::ios::binary | std::ios::app);
+			appendFile(out, task.resultFolder + "/" + data + extension);
+		}
+		coco_remove_directory(task.resultFolder.c_str());
+	}
+
+	for (auto const& info : infoLines){
+		std::ofstream out(folder + "/" + infoNames[info.first]);
+		for (std::string const& line : info.second)
+			out << line << "\n";
+	}
+}
+
+// Files of a task (including those of its islands, see IslandModel) are appended to the file of the campaign
+// with the same suffix. Binary logs are concatenated as well, their reader skips the repeated file headers.
+void Campaign::mergeExtraData() const{
+	for (char const* kind : {".act", ".par", ".pos", ".div", ".rep"}){
+		std::string const extension = kind + std::string(params::log_format == "BINARY" ? ".bin" : "");
+		std::map<std::string, std::ofstream> targets;
+		std::vector<std::string> const files = listFiles(params::extra_data_path, extension);
+		for (CampaignTask const& task : tasks){
+			for (std::string const& file : files){
+				if (file != task.id + extension && file.compare(0, task.id.size() + 7, task.id + "-island") != 0)
+					continue;
+				std::string const part = params::extra_data_path + "/" + file;
+				std::ifstream in(part, std::ios::binary);
+				std::ofstream& out = targets[file.substr(task.id.size())];
+				if (!out.is_open())
+					out.open(params::extra_data_path + "/" + id + file.substr(task.id.size()), std::ios::binary);
+				out << in.rdbuf();
+				in.close();
+				std::remove(part.c_str());
+			}
+		}
+	}
+}
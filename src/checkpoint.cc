@@ -0,0 +1,86 @@
+#include <cstring>
+#include <cstdio>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+#include "checkpoint.h"
+
+static char const MAGIC[4] = {'D', 'E', 'C', 'P'};
+static uint32_t const VERSION = 1;
+
+// The file is the magic number, the version, the size of the data and the data
+Checkpoint::Checkpoint(std::string const filename){
+	FILE* const in = std::fopen(filename.c_str(), "rb");
+	if (!in)
+		throw std::invalid_argument("Failed to open file " + filename);
+	char magic[4];
+	uint32_t version = 0;
+	uint64_t size = 0;
+	bool valid = std::fread(magic, sizeof(magic), 1, in) == 1 && std::memcmp(magic, MAGIC, sizeof(magic)) == 0
+		&& std::fread(&version, sizeof(version), 1, in) == 1 && version == VERSION
+		&& std::fread(&size, sizeof(size), 1, in) == 1;
+	if (valid){
+		data.resize(size);
+		valid = size == 0 || std::fread(data.data(), size, 1, in) == 1;
+	}
+	std::fclose(in);
+	if (!valid)
+		throw std::invalid_argument("Not a checkpoint file: " + filename);
+}
+
+void Checkpoint::save(std::string const filename) const{
+	std::string const temporary = filename + ".tmp";
+	int const fd = open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0)
+		throw std::runtime_error("Failed to open file " + temporary);
+	uint64_t const size = data.size();
+	std::vector<char> file(sizeof(MAGIC) + sizeof(VERSION) + sizeof(size));
+	std::memcpy(&file[0], MAGIC, sizeof(MAGIC));
+	std::memcpy(&file[sizeof(MAGIC)], &VERSION, sizeof(VERSION));
+	std::memcpy(&file[sizeof(MAGIC) + sizeof(VERSION)], &size, sizeof(size));
+	file.insert(file.end(), data.begin(), data.end());
+
+	bool written = true;
+	for (std::size_t done = 0; written && done < file.size();){
+		ssize_t const n = ::write(fd, &file[done], file.size() - done);
+		written = n > 0;
+		done += written ? n : 0;
+	}
+	// The data must be on disk before the rename makes it the checkpoint
+	written = written && fsync(fd) == 0;
+	written = close(fd) == 0 && written;
+	if (!written || std::rename(temporary.c_str(), filename.c_str()) != 0){
+		std::remove(temporary.c_str());
+		throw std::runtime_error("Failed to write checkpoint " + filename);
+	}
+}
+
+void Checkpoint::write(void const* value, std::size_t const size){
+	char const* const bytes = static_cast<char const*>(value);
+	data.insert(data.end(), bytes, bytes + size);
+}
+
+void Checkpoint::read(void* value, std::size_t const size){
+	if (position + size > data.size())
+		throw std::runtime_error("Truncated checkpoint");
+	std::memcpy(value, data.data() + position, size);
+	position += size;
+}
+
+void Checkpoint::append(Checkpoint const& other){
+	data.insert(data.end(), other.data.begin() + other.position, other.data.end());
+}
+
+void Checkpoint::write(std::string const& s){
+	write(uint64_t(s.size()));
+	write(s.data(), s.size());
+}
+
+void Checkpoint::read(std::string& s){
+	uint64_t size;
+	read(size);
+	if (position + size > data.size())
+		throw std::runtime_error("Truncated checkpoint");
+	s.assign(data.data() + position, size);
+	position += size;
+}
@@ -307,6 +307,18 @@ coco_problem_t *coco_problem_remove_observer(coco_problem_t *problem, coco_obser
  */
 const char *coco_observer_get_result_folder(const coco_observer_t *observer);
 
+/**
+ * @brief Saves the evaluation state of an observed problem (counters, best values and logger state) in state,
+ * if not NULL, and returns the number of its values.
+ */
+size_t coco_problem_save_state(const coco_problem_t *problem, double *state);
+
+/**
+ * @brief Restores the evaluation state saved by coco_problem_save_state() into a fresh, identically observed
+ * problem.
+ */
+void coco_problem_restore_state(coco_problem_t *problem, const double *state);
+
 /**@}*/
 
 /***********************************************************************************************************/
@@ -320,6 +332,35 @@ const char *coco_observer_get_result_folder(const coco_observer_t *observer);
  */
 void coco_evaluate_function(coco_problem_t *problem, const double *x, double *y);
 
+/**
+ * @brief Records an evaluation in point x whose function value y was computed beforehand, e.g. by
+ * coco_compute_function().
+ */
+void coco_evaluate_function_given(coco_problem_t *problem, const double *x, double *y);
+
+/**
+ * @brief Evaluates the problem function in the n points stored one after the other in x and saves the
+ * results in y.
+ */
+void coco_evaluate_function_batch(coco_problem_t *problem, const double *x, const size_t n, double *y);
+
+/**
+ * @brief Computes the function value in point x without recording the evaluation; may be called by several
+ * threads at once on the same problem.
+ */
+void coco_compute_function(coco_problem_t *problem, const double *x, double *y);
+
+/**
+ * @brief Computes the function values in the n points stored one after the other in x without recording the
+ * evaluations; may be called by several threads at once on the same problem.
+ */
+void coco_compute_function_batch(coco_problem_t *problem, const double *x, const size_t n, double *y);
+
+/**
+ * @brief Returns a new, unobserved instance of the same problem, which can be evaluated from another thread.
+ */
+coco_problem_t *coco_problem_clone(const coco_problem_t *problem);
+
 /**
  * @brief Evaluates the problem constraints in point x and save the result in y.
  */
@@ -516,6 +557,12 @@ void coco_debug(const char *message, ...);
  * @brief Sets the COCO log level to the given value and returns the previous value of the log level.
  */
 const char *coco_set_log_level(const char *level);
+
+/**
+ * @brief Selects the instruction set of the vectorized bbob raw functions ("none", "sse2", "avx2" or "auto")
+ * and returns the one in effect.
+ */
+const char *coco_set_simd_level(const char *level);
 /**@}*/
 
 /***********************************************************************************************************/
@@ -735,6 +782,14 @@ typedef void (*coco_problem_free_function_t)(coco_problem_t *problem);
  */
 typedef void (*coco_evaluate_function_t)(coco_problem_t *problem, const double *x, double *y);
 
+/**
+ * @brief The batch evaluate function type.
+ *
+ * This is a template for functions that evaluate the problem function in n points at once, stored one after
+ * the other in x, saving the i-th result in y[i].
+ */
+typedef void (*coco_evaluate_batch_function_t)(coco_problem_t *problem, const double *x, const size_t n, double *y);
+
 /**
  * @brief The recommend solutions function type.
  *
@@ -823,6 +878,8 @@ struct coco_problem_s {
   coco_evaluate_function_t evaluate_function;         /**< @brief  The function for evaluating the problem. */
   coco_evaluate_function_t evaluate_constraint;       /**< @brief  The function for evaluating the constraints. */
   coco_evaluate_function_t evaluate_gradient;         /**< @brief  The function for evaluating the constraints. */
+  coco_evaluate_batch_function_t evaluate_function_batch; /**< @brief  The function for evaluating the problem
+                                                         in a batch of points, or NULL to evaluate them one by one. */
   coco_recommend_function_t recommend_solution;       /**< @brief  The function for recommending a solution. */
   coco_problem_free_function_t problem_free_function; /**< @brief  The function for freeing this problem. */
 
@@ -866,6 +923,8 @@ struct coco_problem_s {
   void *data;                          /**< @brief Pointer to a data instance @see coco_problem_transformed_data_t */
   
   void *versatile_data;                /* Wassim: *< @brief pointer to eventual additional data that need to be accessed all along the transforamtions*/
+
+  int is_logger;                       /**< @brief Whether this problem is a logger layer added by an observer */
 };
 
 /**
@@ -1103,7 +1162,7 @@ static char *coco_strdup(const char *string) {
  * @brief Formatted string duplication, with va_list arguments.
  */
 static char *coco_vstrdupf(const char *str, va_list args) {
-  static char buf[COCO_VSTRDUPF_BUFLEN];
+  static __thread char buf[COCO_VSTRDUPF_BUFLEN]; /* Per thread: loggers also format file names at the first evaluation */
   long written;
   /* apparently args can only be used once, therefore
    * len = vsnprintf(NULL, 0, str, args) to find out the
@@ -1984,6 +2043,10 @@ int coco_remove_file(const char *file_name) {
 /**@{*/
 double *coco_allocate_vector(const size_t number_of_elements) {
   const size_t block_size = number_of_elements * sizeof(double);
+  if (number_of_elements == 0) { /* Checked here too, so that the vector is known not to be empty where it is filled */
+    coco_error("coco_allocate_vector() called with 0 elements.");
+    return NULL; /* never reached */
+  }
   return (double *) coco_allocate_memory(block_size);
 }
 
@@ -2723,6 +2786,561 @@ static int coco_vector_is_zero(const double *x, const size_t dim) {
 
 #line 8 "code-experiments/src/suite_bbob.c"
 
+#line 1 "code-experiments/src/coco_simd.c"
+/**
+ * @file coco_simd.c
+ * @brief Vectorized kernels of the separable raw functions of the bbob suite and of the affine transformations,
+ * with a runtime selection of the instruction set.
+ *
+ * The kernels process two (SSE2) or four (AVX2) coordinates at a time. Sums are accumulated per lane and
+ * reduced at the end, and cos, exp and log are evaluated with polynomial approximations: an fdlibm style
+ * argument reduction for cos, and double-double intermediate results for powers, whose error would otherwise
+ * be magnified by the exponent. The results therefore agree with the scalar code to a few ULP rather than bit
+ * for bit. Blocks of coordinates outside the range of the approximations (huge, subnormal or zero values) are
+ * evaluated with the scalar code, and the "none" level restores it everywhere.
+ *
+ * The affine kernels are the exception: they vectorize over the rows of the matrix rather than along them,
+ * with separate multiplications and additions, so every row is computed exactly as by the scalar code.
+ *
+ * The raw functions call the kernels only where bench/simd measures them faster than the scalar code: the
+ * sphere, ellipsoids, Rastrigin, Bueche-Rastrigin, bent cigar and different powers, and the rotations. The
+ * discus stays scalar, as do the linear slope and step ellipsoid, which compute their own transformations.
+ */
+
+#include <math.h>
+#include <float.h>
+
+#line 17 "code-experiments/src/coco_simd.c"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define COCO_SIMD_X86
+#include <immintrin.h>
+#define COCO_SIMD_SSE2_TARGET __attribute__((target("sse2")))
+#define COCO_SIMD_AVX2_TARGET __attribute__((target("avx2,fma")))
+#define COCO_SIMD_AVX2_EXACT_TARGET __attribute__((target("avx2"))) /* Without fma, no product is fused */
+#endif
+
+/**
+ * @brief The instruction sets of the vectorized kernels, in increasing order.
+ */
+enum { COCO_SIMD_NONE = 0, COCO_SIMD_SSE2 = 1, COCO_SIMD_AVX2 = 2 };
+
+static const char *coco_simd_level_names[] = { "none", "sse2", "avx2" };
+
+static int coco_simd_level = -1; /* Detected on first use */
+
+/**
+ * @brief Returns the best instruction set supported by the CPU.
+ */
+static int coco_simd_supported_level(void) {
+#ifdef COCO_SIMD_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+    return COCO_SIMD_AVX2;
+  if (__builtin_cpu_supports("sse2"))
+    return COCO_SIMD_SSE2;
+#endif
+  return COCO_SIMD_NONE;
+}
+
+/**
+ * @brief Returns the instruction set in effect.
+ */
+static int coco_simd_get_level(void) {
+  if (coco_simd_level < 0)
+    coco_simd_level = coco_simd_supported_level();
+  return coco_simd_level;
+}
+
+/**
+ * Selects the instruction set used by the vectorized raw functions. Levels that the CPU does not support are
+ * lowered to the best one it does.
+ *
+ * @note Not thread-safe, to be called before evaluating problems.
+ *
+ * @param level "none" (the scalar code), "sse2", "avx2" or "auto" (the best level the CPU supports).
+ *
+ * @return The level in effect.
+ */
+const char *coco_set_simd_level(const char *level) {
+  const int supported = coco_simd_supported_level();
+  int requested = -1;
+
+  if (strcmp(level, "auto") == 0)
+    requested = supported;
+  else if (strcmp(level, "none") == 0)
+    requested = COCO_SIMD_NONE;
+  else if (strcmp(level, "sse2") == 0)
+    requested = COCO_SIMD_SSE2;
+  else if (strcmp(level, "avx2") == 0)
+    requested = COCO_SIMD_AVX2;
+  else
+    coco_warning("coco_set_simd_level(): unknown level %s", level);
+
+  if (requested >= 0)
+    coco_simd_level = requested < supported ? requested : supported;
+  return coco_simd_level_names[coco_simd_get_level()];
+}
+
+#ifdef COCO_SIMD_X86
+
+static const double coco_simd_ln2_hi = 6.93147180369123816490e-01; /* The upper 32 bits of ln(2) */
+static const double coco_simd_ln2_lo = 1.90821492927058770002e-10;
+static const double coco_simd_pio2_1 = 1.57079632673412561417e+00; /* pi/2 in three parts of 33 bits */
+static const double coco_simd_pio2_2 = 6.07710050630396597660e-11;
+static const double coco_simd_pio2_3 = 2.02226624871116645580e-21;
+static const double coco_simd_int_magic = 6755399441055744.0; /* 2^52 + 2^51, exposes small integers in the low bits */
+
+/**
+ * @brief Returns the sum of the four lanes.
+ */
+COCO_SIMD_AVX2_TARGET static double coco_simd_avx2_sum(const __m256d v) {
+  __m128d s = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+  return _mm_cvtsd_f64(_mm_add_sd(s, _mm_unpackhi_pd(s, s)));
+}
+
+/**
+ * @brief Returns whether all lanes of |v| are within [lower, upper).
+ */
+COCO_SIMD_AVX2_TARGET static int coco_simd_avx2_in_range(const __m256d v, const double lower, const double upper) {
+  const __m256d a = _mm256_andnot_pd(_mm256_set1_pd(-0.0), v);
+  const __m256d inside = _mm256_and_pd(_mm256_cmp_pd(a, _mm256_set1_pd(lower), _CMP_GE_OQ),
+      _mm256_cmp_pd(a, _mm256_set1_pd(upper), _CMP_LT_OQ));
+  return _mm256_movemask_pd(inside) == 0xF;
+}
+
+/**
+ * @brief Computes exp(hi + lo) for |hi| < 700, with lo a small correction of hi.
+ */
+COCO_SIMD_AVX2_TARGET static __m256d coco_simd_avx2_exp(const __m256d hi, const __m256d lo) {
+  static const double coefficients[] = { 1.0 / 6227020800.0, 1.0 / 479001600.0, 1.0 / 39916800.0,
+      1.0 / 3628800.0, 1.0 / 362880.0, 1.0 / 40320.0, 1.0 / 5040.0, 1.0 / 720.0, 1.0 / 120.0, 1.0 / 24.0,
+      1.0 / 6.0, 0.5, 1.0, 1.0 };
+  const __m256d magic = _mm256_set1_pd(coco_simd_int_magic);
+  __m256d k, r, p;
+  __m256i e;
+  size_t i;
+
+  /* hi + lo = k ln(2) + r, with |r| <= ln(2) / 2 */
+  k = _mm256_round_pd(_mm256_mul_pd(hi, _mm256_set1_pd(1.0 / coco_simd_ln2_hi)),
+      _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+  r = _mm256_fnmadd_pd(k, _mm256_set1_pd(coco_simd_ln2_hi), hi);
+  r = _mm256_fnmadd_pd(k, _mm256_set1_pd(coco_simd_ln2_lo), r);
+  r = _mm256_add_pd(r, lo);
+
+  /* Taylor polynomial of degree 13 */
+  p = _mm256_set1_pd(coefficients[0]);
+  for (i = 1; i < sizeof(coefficients) / sizeof(coefficients[0]); i++)
+    p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(coefficients[i]));
+
+  /* Multiply by 2^k, built in the exponent bits */
+  e = _mm256_sub_epi64(_mm256_castpd_si256(_mm256_add_pd(k, magic)), _mm256_castpd_si256(magic));
+  e = _mm256_slli_epi64(_mm256_add_epi64(e, _mm256_set1_epi64x(1023)), 52);
+  return _mm256_mul_pd(p, _mm256_castsi256_pd(e));
+}
+
+/**
+ * @brief Computes log(x) = *hi + *lo as a double-double, for positive normal x.
+ */
+COCO_SIMD_AVX2_TARGET static void coco_simd_avx2_log(const __m256d x, __m256d *hi, __m256d *lo) {
+  static const double coefficients[] = { 2.0 / 25.0, 2.0 / 23.0, 2.0 / 21.0, 2.0 / 19.0, 2.0 / 17.0,
+      2.0 / 15.0, 2.0 / 13.0, 2.0 / 11.0, 2.0 / 9.0, 2.0 / 7.0, 2.0 / 5.0, 2.0 / 3.0 };
+  const __m256d one = _mm256_set1_pd(1.0);
+  const __m256d magic = _mm256_set1_pd(coco_simd_int_magic);
+  __m256d m, e, large, num, den, den_lo, bb, t, t_lo, z, p, s, s_lo, a, c;
+  __m256i bits;
+  size_t i;
+
+  /* x = 2^e m, with m in [sqrt(2)/2, sqrt(2)) */
+  bits = _mm256_castpd_si256(x);
+  m = _mm256_or_pd(_mm256_and_pd(x, _mm256_castsi256_pd(_mm256_srli_epi64(_mm256_set1_epi32(-1), 12))), one);
+  e = _mm256_sub_pd(_mm256_castsi256_pd(_mm256_add_epi64(_mm256_srli_epi64(bits, 52),
+      _mm256_castpd_si256(magic))), magic);
+  e = _mm256_sub_pd(e, _mm256_set1_pd(1023.0));
+  large = _mm256_cmp_pd(m, _mm256_set1_pd(1.41421356237309504880), _CMP_GT_OQ);
+  m = _mm256_blendv_pd(m, _mm256_mul_pd(m, _mm256_set1_pd(0.5)), large);
+  e = _mm256_add_pd(e, _mm256_and_pd(large, one));
+
+  /* t = (m - 1) / (m + 1) in double-double, m - 1 is exact */
+  num = _mm256_sub_pd(m, one);
+  den = _mm256_add_pd(m, one);
+  bb = _mm256_sub_pd(den, m);
+  den_lo = _mm256_add_pd(_mm256_sub_pd(m, _mm256_sub_pd(den, bb)), _mm256_sub_pd(one, bb));
+  t = _mm256_div_pd(num, den);
+  t_lo = _mm256_fnmadd_pd(t, den, num);
+  t_lo = _mm256_fnmadd_pd(t, den_lo, t_lo);
+  t_lo = _mm256_div_pd(t_lo, den);
+
+  /* log(m) = 2t + 2t^3/3 + 2t^5/5 + ..., with |t| < 0.172 */
+  z = _mm256_mul_pd(t, t);
+  p = _mm256_set1_pd(coefficients[0]);
+  for (i = 1; i < sizeof(coefficients) / sizeof(coefficients[0]); i++)
+    p = _mm256_fmadd_pd(p, z, _mm256_set1_pd(coefficients[i]));
+  c = _mm256_fmadd_pd(_mm256_mul_pd(z, t), p, _mm256_add_pd(t_lo, t_lo));
+  c = _mm256_fmadd_pd(e, _mm256_set1_pd(coco_simd_ln2_lo), c);
+
+  /* log(x) = e ln(2) + log(m), e ln(2)_hi is exact */
+  a = _mm256_mul_pd(e, _mm256_set1_pd(coco_simd_ln2_hi));
+  t = _mm256_add_pd(t, t);
+  s = _mm256_add_pd(a, t);
+  bb = _mm256_sub_pd(s, a);
+  s_lo = _mm256_add_pd(_mm256_sub_pd(a, _mm256_sub_pd(s, bb)), _mm256_sub_pd(t, bb));
+  s_lo = _mm256_add_pd(s_lo, c);
+  *hi = _mm256_add_pd(s, s_lo);
+  *lo = _mm256_sub_pd(s_lo, _mm256_sub_pd(*hi, s));
+}
+
+/**
+ * @brief Computes exp(y (hi + lo)), and in *exponent the leading part of y (hi + lo), which must be below 700 in
+ * absolute value.
+ */
+COCO_SIMD_AVX2_TARGET static __m256d coco_simd_avx2_exp_product(const __m256d y, const __m256d hi, const __m256d lo,
+                                                                __m256d *exponent) {
+  const __m256d p = _mm256_mul_pd(y, hi);
+  *exponent = p;
+  return coco_simd_avx2_exp(p, _mm256_fmadd_pd(y, lo, _mm256_fmsub_pd(y, hi, p)));
+}
+
+/**
+ * @brief Computes cos(t) for |t| < 1e5.
+ */
+COCO_SIMD_AVX2_TARGET static __m256d coco_simd_avx2_cos(const __m256d t) {
+  static const double s[] = { 1.58969099521155010221e-10, -2.50507602534068634195e-08,
+      2.75573137070700676789e-06, -1.98412698298579493134e-04, 8.33333333332248946124e-03,
+      -1.66666666666666324348e-01 };
+  static const double c[] = { -1.13596475577881948265e-11, 2.08757232129817482790e-09,
+      -2.75573143513906633035e-07, 2.48015872894767294178e-05, -1.38888888888741095749e-03,
+      4.16666666666666019037e-02 };
+  const __m256d one = _mm256_set1_pd(1.0);
+  __m256d q, r, z, ps, pc, sine, cosine, hz, w, result;
+  __m256i quadrant, use_sine, negate;
+  size_t i;
+
+  /* t = q pi/2 + r, with |r| <= pi/4 */
+  q = _mm256_round_pd(_mm256_mul_pd(t, _mm256_set1_pd(6.36619772367581382433e-01)),
+      _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+  r = _mm256_fnmadd_pd(q, _mm256_set1_pd(coco_simd_pio2_1), t);
+  r = _mm256_fnmadd_pd(q, _mm256_set1_pd(coco_simd_pio2_2), r);
+  r = _mm256_fnmadd_pd(q, _mm256_set1_pd(coco_simd_pio2_3), r);
+
+  /* The fdlibm kernels of sin and cos on [-pi/4, pi/4] */
+  z = _mm256_mul_pd(r, r);
+  ps = _mm256_set1_pd(s[0]);
+  pc = _mm256_set1_pd(c[0]);
+  for (i = 1; i < sizeof(s) / sizeof(s[0]); i++) {
+    ps = _mm256_fmadd_pd(ps, z, _mm256_set1_pd(s[i]));
+    pc = _mm256_fmadd_pd(pc, z, _mm256_set1_pd(c[i]));
+  }
+  sine = _mm256_fmadd_pd(_mm256_mul_pd(z, r), ps, r);
+  hz = _mm256_mul_pd(_mm256_set1_pd(0.5), z);
+  w = _mm256_sub_pd(one, hz);
+  cosine = _mm256_add_pd(w, _mm256_fmadd_pd(_mm256_mul_pd(z, z), pc,
+      _mm256_sub_pd(_mm256_sub_pd(one, w), hz)));
+
+  /* Quadrants 0..3 give cos(r), -sin(r), -cos(r), sin(r) */
+  quadrant = _mm256_cvtepi32_epi64(_mm256_cvtpd_epi32(q));
+  use_sine = _mm256_cmpeq_epi64(_mm256_and_si256(quadrant, _mm256_set1_epi64x(1)), _mm256_set1_epi64x(1));
+  negate = _mm256_slli_epi64(_mm256_and_si256(_mm256_add_epi64(quadrant, _mm256_set1_epi64x(1)),
+      _mm256_set1_epi64x(2)), 62);
+  result = _mm256_blendv_pd(cosine, sine, _mm256_castsi256_pd(use_sine));
+  return _mm256_xor_pd(result, _mm256_castsi256_pd(negate));
+}
+
+/**
+ * @brief AVX2 kernel of coco_simd_sum_of_scaled_squares().
+ */
+COCO_SIMD_AVX2_TARGET static double coco_simd_avx2_sum_of_scaled_squares(const double *x, const size_t n,
+                                                                        const double factor, double result) {
+  const __m256d f = _mm256_set1_pd(factor);
+  __m256d sum = _mm256_setzero_pd();
+  size_t i;
+  for (i = 0; i + 4 <= n; i += 4) {
+    const __m256d v = _mm256_loadu_pd(x + i);
+    sum = _mm256_fmadd_pd(_mm256_mul_pd(f, v), v, sum);
+  }
+  result += coco_simd_avx2_sum(sum);
+  for (; i < n; i++)
+    result += factor * x[i] * x[i];
+  return result;
+}
+
+/**
+ * @brief SSE2 kernel of coco_simd_sum_of_scaled_squares().
+ */
+COCO_SIMD_SSE2_TARGET static double coco_simd_sse2_sum_of_scaled_squares(const double *x, const size_t n,
+                                                                        const double factor, double result) {
+  const __m128d f = _mm_set1_pd(factor);
+  __m128d sum = _mm_setzero_pd();
+  size_t i;
+  for (i = 0; i + 2 <= n; i += 2) {
+    const __m128d v = _mm_loadu_pd(x + i);
+    sum = _mm_add_pd(sum, _mm_mul_pd(_mm_mul_pd(f, v), v));
+  }
+  result += _mm_cvtsd_f64(_mm_add_sd(sum, _mm_unpackhi_pd(sum, sum)));
+  for (; i < n; i++)
+    result += factor * x[i] * x[i];
+  return result;
+}
+
+/**
+ * @brief AVX2 kernel of coco_simd_sum_of_cosines().
+ */
+COCO_SIMD_AVX2_TARGET static double coco_simd_avx2_sum_of_cosines(const double *x, const size_t n,
+                                                                  const double frequency) {
+  const __m256d f = _mm256_set1_pd(frequency);
+  __m256d sum = _mm256_setzero_pd();
+  double result;
+  size_t i, j;
+  for (i = 0; i + 4 <= n; i += 4) {
+    const __m256d t = _mm256_mul_pd(f, _mm256_loadu_pd(x + i));
+    if (coco_simd_avx2_in_range(t, 0.0, 1e5)) {
+      sum = _mm256_add_pd(sum, coco_simd_avx2_cos(t));
+    } else {
+      double block[4];
+      for (j = 0; j < 4; j++)
+        block[j] = cos(frequency * x[i + j]);
+      sum = _mm256_add_pd(sum, _mm256_loadu_pd(block));
+    }
+  }
+  result = coco_simd_avx2_sum(sum);
+  for (; i < n; i++)
+    result += cos(frequency * x[i]);
+  return result;
+}
+
+/**
+ * @brief AVX2 kernel of coco_simd_sum_of_conditioned_squares().
+ */
+COCO_SIMD_AVX2_TARGET static double coco_simd_avx2_sum_of_conditioned_squares(const double *x, const size_t n,
+                                                                              const double condition) {
+  const __m256d last = _mm256_set1_pd((double) (long) n - 1.0);
+  __m256d index = _mm256_set_pd(3.0, 2.0, 1.0, 0.0);
+  __m256d sum = _mm256_setzero_pd(), log_hi, log_lo, exponent;
+  double result;
+  size_t i;
+  coco_simd_avx2_log(_mm256_set1_pd(condition), &log_hi, &log_lo);
+  for (i = 0; i + 4 <= n; i += 4) {
+    const __m256d v = _mm256_loadu_pd(x + i);
+    const __m256d w = coco_simd_avx2_exp_product(_mm256_div_pd(index, last), log_hi, log_lo, &exponent);
+    sum = _mm256_fmadd_pd(_mm256_mul_pd(w, v), v, sum);
+    index = _mm256_add_pd(index, _mm256_set1_pd(4.0));
+  }
+  result = coco_simd_avx2_sum(sum);
+  for (; i < n; i++)
+    result += pow(condition, (double) (long) i / ((double) (long) n - 1.0)) * x[i] * x[i];
+  return result;
+}
+
+/**
+ * @brief AVX2 kernel of coco_simd_sum_of_different_powers().
+ */
+COCO_SIMD_AVX2_TARGET static double coco_simd_avx2_sum_of_different_powers(const double *x, const size_t n) {
+  const __m256d last = _mm256_set1_pd((double) (long) n - 1.0);
+  __m256d index = _mm256_set_pd(3.0, 2.0, 1.0, 0.0);
+  __m256d sum = _mm256_setzero_pd(), p, log_hi, log_lo, exponent;
+  double result;
+  size_t i, j;
+  int is_regular;
+  for (i = 0; i + 4 <= n; i += 4) {
+    const __m256d v = _mm256_andnot_pd(_mm256_set1_pd(-0.0), _mm256_loadu_pd(x + i));
+    const __m256d y = _mm256_add_pd(_mm256_set1_pd(2.0), _mm256_div_pd(_mm256_mul_pd(_mm256_set1_pd(4.0), index),
+        last));
+    p = _mm256_setzero_pd();
+    is_regular = coco_simd_avx2_in_range(v, DBL_MIN, DBL_MAX);
+    if (is_regular) {
+      coco_simd_avx2_log(v, &log_hi, &log_lo);
+      p = coco_simd_avx2_exp_product(y, log_hi, log_lo, &exponent);
+      is_regular = coco_simd_avx2_in_range(exponent, 0.0, 700.0);
+    }
+    if (!is_regular) {
+      double block[4];
+      for (j = 0; j < 4; j++)
+        block[j] = pow(fabs(x[i + j]), 2.0 + (4.0 * (double) (long) (i + j)) / ((double) (long) n - 1.0));
+      p = _mm256_loadu_pd(block);
+    }
+    sum = _mm256_add_pd(sum, p);
+    index = _mm256_add_pd(index, _mm256_set1_pd(4.0));
+  }
+  result = coco_simd_avx2_sum(sum);
+  for (; i < n; i++)
+    result += pow(fabs(x[i]), 2.0 + (4.0 * (double) (long) i) / ((double) (long) n - 1.0));
+  return result;
+}
+
+
+/**
+ * @brief AVX2 kernel of coco_simd_affine_rows(), which computes 16 rows at a time and then 4. Returns the
+ * first row that is left to the caller.
+ */
+COCO_SIMD_AVX2_EXACT_TARGET static size_t coco_simd_avx2_affine_rows(const double *Mt, const double *b,
+                                                                    const double *x, double *z,
+                                                                    const size_t rows, const size_t columns,
+                                                                    size_t i, const size_t end) {
+  size_t j;
+  for (; i + 16 <= end; i += 16) {
+    __m256d z0 = _mm256_loadu_pd(b + i), z1 = _mm256_loadu_pd(b + i + 4);
+    __m256d z2 = _mm256_loadu_pd(b + i + 8), z3 = _mm256_loadu_pd(b + i + 12);
+    for (j = 0; j < columns; ++j) {
+      const double *column = Mt + j * rows + i;
+      const __m256d v = _mm256_set1_pd(x[j]);
+      z0 = _mm256_add_pd(z0, _mm256_mul_pd(v, _mm256_loadu_pd(column)));
+      z1 = _mm256_add_pd(z1, _mm256_mul_pd(v, _mm256_loadu_pd(column + 4)));
+      z2 = _mm256_add_pd(z2, _mm256_mul_pd(v, _mm256_loadu_pd(column + 8)));
+      z3 = _mm256_add_pd(z3, _mm256_mul_pd(v, _mm256_loadu_pd(column + 12)));
+    }
+    _mm256_storeu_pd(z + i, z0);
+    _mm256_storeu_pd(z + i + 4, z1);
+    _mm256_storeu_pd(z + i + 8, z2);
+    _mm256_storeu_pd(z + i + 12, z3);
+  }
+  for (; i + 4 <= end; i += 4) {
+    __m256d z0 = _mm256_loadu_pd(b + i);
+    for (j = 0; j < columns; ++j)
+      z0 = _mm256_add_pd(z0, _mm256_mul_pd(_mm256_set1_pd(x[j]), _mm256_loadu_pd(Mt + j * rows + i)));
+    _mm256_storeu_pd(z + i, z0);
+  }
+  return i;
+}
+
+/**
+ * @brief SSE2 kernel of coco_simd_affine_rows(), which computes 8 rows at a time and then 2. Returns the
+ * first row that is left to the caller.
+ */
+COCO_SIMD_SSE2_TARGET static size_t coco_simd_sse2_affine_rows(const double *Mt, const double *b,
+                                                              const double *x, double *z,
+                                                              const size_t rows, const size_t columns,
+                                                              size_t i, const size_t end) {
+  size_t j;
+  for (; i + 8 <= end; i += 8) {
+    __m128d z0 = _mm_loadu_pd(b + i), z1 = _mm_loadu_pd(b + i + 2);
+    __m128d z2 = _mm_loadu_pd(b + i + 4), z3 = _mm_loadu_pd(b + i + 6);
+    for (j = 0; j < columns; ++j) {
+      const double *column = Mt + j * rows + i;
+      const __m128d v = _mm_set1_pd(x[j]);
+      z0 = _mm_add_pd(z0, _mm_mul_pd(v, _mm_loadu_pd(column)));
+      z1 = _mm_add_pd(z1, _mm_mul_pd(v, _mm_loadu_pd(column + 2)));
+      z2 = _mm_add_pd(z2, _mm_mul_pd(v, _mm_loadu_pd(column + 4)));
+      z3 = _mm_add_pd(z3, _mm_mul_pd(v, _mm_loadu_pd(column + 6)));
+    }
+    _mm_storeu_pd(z + i, z0);
+    _mm_storeu_pd(z + i + 2, z1);
+    _mm_storeu_pd(z + i + 4, z2);
+    _mm_storeu_pd(z + i + 6, z3);
+  }
+  for (; i + 2 <= end; i += 2) {
+    __m128d z0 = _mm_loadu_pd(b + i);
+    for (j = 0; j < columns; ++j)
+      z0 = _mm_add_pd(z0, _mm_mul_pd(_mm_set1_pd(x[j]), _mm_loadu_pd(Mt + j * rows + i)));
+    _mm_storeu_pd(z + i, z0);
+  }
+  return i;
+}
+#endif
+
+/**
+ * @brief Returns result + sum_i factor x_i^2, accumulated from left to right by the scalar code.
+ */
+static double coco_simd_sum_of_scaled_squares(const double *x, const size_t n, const double factor,
+                                              double result) {
+  size_t i;
+#ifdef COCO_SIMD_X86
+  if (coco_simd_get_level() == COCO_SIMD_AVX2)
+    return coco_simd_avx2_sum_of_scaled_squares(x, n, factor, result);
+  if (coco_simd_get_level() == COCO_SIMD_SSE2)
+    return coco_simd_sse2_sum_of_scaled_squares(x, n, factor, result);
+#endif
+  for (i = 0; i < n; ++i)
+    result += factor * x[i] * x[i];
+  return result;
+}
+
+/**
+ * @brief Returns sum_i cos(frequency x_i).
+ */
+static double coco_simd_sum_of_cosines(const double *x, const size_t n, const double frequency) {
+  double result = 0.0;
+  size_t i;
+#ifdef COCO_SIMD_X86
+  if (coco_simd_get_level() == COCO_SIMD_AVX2)
+    return coco_simd_avx2_sum_of_cosines(x, n, frequency);
+#endif
+  for (i = 0; i < n; ++i)
+    result += cos(frequency * x[i]);
+  return result;
+}
+
+/**
+ * @brief Returns sum_i condition^(i / (n - 1)) x_i^2, for n > 1.
+ */
+static double coco_simd_sum_of_conditioned_squares(const double *x, const size_t n, const double condition) {
+  double result;
+  size_t i;
+#ifdef COCO_SIMD_X86
+  if (coco_simd_get_level() == COCO_SIMD_AVX2)
+    return coco_simd_avx2_sum_of_conditioned_squares(x, n, condition);
+#endif
+  result = x[0] * x[0];
+  for (i = 1; i < n; ++i) {
+    const double exponent = 1.0 * (double) (long) i / ((double) (long) n - 1.0);
+    result += pow(condition, exponent) * x[i] * x[i];
+  }
+  return result;
+}
+
+/**
+ * @brief Returns sum_i |x_i|^(2 + 4 i / (n - 1)), for n > 1.
+ */
+static double coco_simd_sum_of_different_powers(const double *x, const size_t n) {
+  double result = 0.0;
+  size_t i;
+#ifdef COCO_SIMD_X86
+  if (coco_simd_get_level() == COCO_SIMD_AVX2)
+    return coco_simd_avx2_sum_of_different_powers(x, n);
+#endif
+  for (i = 0; i < n; ++i) {
+    double exponent = 2.0 + (4.0 * (double) (long) i) / ((double) (long) n - 1.0);
+    result += pow(fabs(x[i]), exponent);
+  }
+  return result;
+}
+
+/**
+ * @brief Computes the rows i to end - 1 of z = M x + b, for the rows x columns matrix M and its transpose Mt.
+ * Each row is accumulated from left to right as by the scalar code, the kernels computing several rows side
+ * by side from the columns of M.
+ */
+static void coco_simd_affine_rows(const double *M, const double *Mt, const double *b, const double *x,
+                                  double *z, const size_t rows, const size_t columns, size_t i,
+                                  const size_t end) {
+  size_t j;
+#ifdef COCO_SIMD_X86
+  if (coco_simd_get_level() == COCO_SIMD_AVX2)
+    i = coco_simd_avx2_affine_rows(Mt, b, x, z, rows, columns, i, end);
+  else if (coco_simd_get_level() == COCO_SIMD_SSE2)
+    i = coco_simd_sse2_affine_rows(Mt, b, x, z, rows, columns, i, end);
+#endif
+  for (; i < end; ++i) {
+    z[i] = b[i];
+    for (j = 0; j < columns; ++j)
+      z[i] += x[j] * M[i * columns + j];
+  }
+}
+
+/**
+ * @brief Computes z_k = M x_k + b for count points x_k stored one after the other, for the rows x columns
+ * matrix M and its transpose Mt. The rows are processed in panels small enough for the cache, each panel
+ * multiplying all points before the next one is loaded (a blocked product of M and the matrix of points).
+ */
+static void coco_simd_affine(const double *M, const double *Mt, const double *b, const double *x, double *z,
+                             const size_t rows, const size_t columns, const size_t count) {
+  const size_t panel = 16 * (columns < 128 ? 128 / columns : 1); /* Rows of at most 16 KiB of Mt */
+  size_t i, k;
+  for (i = 0; i < rows; i += panel)
+    for (k = 0; k < count; ++k)
+      coco_simd_affine_rows(M, Mt, b, x + k * columns, z + k * rows, rows, columns, i,
+          i + panel < rows ? i + panel : rows);
+}
+#line 9 "code-experiments/src/suite_bbob.c"
 #line 1 "code-experiments/src/f_attractive_sector.c"
 /**
  * @file f_attractive_sector.c
@@ -2740,6 +3358,7 @@ static int coco_vector_is_zero(const double *x, const size_t dim) {
  */
 
 #include <float.h>
+#include <pthread.h>
 #line 8 "code-experiments/src/coco_problem.c"
 #line 9 "code-experiments/src/coco_problem.c"
 
@@ -2762,6 +3381,81 @@ static int coco_vector_is_zero(const double *x, const size_t dim) {
  * @param y The objective vector that is the result of the evaluation (in single-objective problems only the
  * first vector item is being set).
  */
+static __thread int coco_evaluation_is_given = 0; /* Set during coco_evaluate_function_given(), per thread */
+static __thread double coco_given_fvalue;
+static __thread int coco_evaluation_is_computed = 0; /* Set during coco_compute_function(), per thread */
+
+/* The workspace of a thread, for the buffers of batch evaluations and computations (see coco_scratch_get()). The
+ * transformations take slices of it as a stack. Between evaluations, it grows to the largest demand of the thread,
+ * after which evaluations no longer allocate. */
+static __thread double *coco_scratch_workspace = NULL;
+static __thread size_t coco_scratch_capacity = 0;
+static __thread size_t coco_scratch_used = 0;
+static __thread size_t coco_scratch_demand = 0; /* Largest size needed so far, including the slices that did not fit */
+static pthread_key_t coco_scratch_key;
+static pthread_once_t coco_scratch_key_once = PTHREAD_ONCE_INIT;
+
+static void coco_scratch_free_workspace(void *workspace) {
+  coco_free_memory(workspace);
+}
+
+static void coco_scratch_create_key(void) {
+  pthread_key_create(&coco_scratch_key, coco_scratch_free_workspace); /* Frees the workspace at thread exit */
+}
+
+/**
+ * @brief Returns a slice of the workspace of the thread, or a fresh vector if it does not fit in it yet.
+ */
+static double *coco_scratch_take(const size_t size) {
+  double *scratch;
+  if (coco_scratch_used + size > coco_scratch_demand)
+    coco_scratch_demand = coco_scratch_used + size;
+  if (coco_scratch_used + size > coco_scratch_capacity)
+    return coco_allocate_vector(size);
+  scratch = coco_scratch_workspace + coco_scratch_used;
+  coco_scratch_used += size;
+  return scratch;
+}
+
+/**
+ * @brief Returns the buffer of a transformation for a single-threaded evaluation, or a slice of the workspace of
+ * the thread in a computation (see coco_compute_function()), which may run in several threads at once.
+ */
+static double *coco_scratch_get(double *buffer, const size_t size) {
+  return coco_evaluation_is_computed ? coco_scratch_take(size) : buffer;
+}
+
+/**
+ * @brief Releases a vector obtained from coco_scratch_get() or, with a NULL buffer, from coco_scratch_take().
+ * A slice is released with all slices taken after it.
+ */
+static void coco_scratch_release(double *scratch, const double *buffer) {
+  if (scratch == buffer)
+    return;
+  if (coco_scratch_workspace == NULL || scratch < coco_scratch_workspace
+      || scratch >= coco_scratch_workspace + coco_scratch_capacity) {
+    coco_free_memory(scratch);
+  } else if ((size_t) (scratch - coco_scratch_workspace) < coco_scratch_used) {
+    coco_scratch_used = (size_t) (scratch - coco_scratch_workspace);
+  }
+}
+
+/**
+ * @brief Grows the workspace of the thread to the largest demand so far, while none of it is in use.
+ */
+static void coco_scratch_reserve(void) {
+  if (coco_scratch_used > 0 || coco_scratch_demand <= coco_scratch_capacity)
+    return;
+  pthread_once(&coco_scratch_key_once, coco_scratch_create_key);
+  if (coco_scratch_workspace != NULL)
+    coco_free_memory(coco_scratch_workspace);
+  coco_scratch_workspace = coco_allocate_vector(coco_scratch_demand);
+  coco_scratch_capacity = coco_scratch_demand;
+  pthread_setspecific(coco_scratch_key, coco_scratch_workspace);
+}
+
+static coco_problem_t *coco_problem_transformed_get_inner_problem(const coco_problem_t *problem);
+
 void coco_evaluate_function(coco_problem_t *problem, const double *x, double *y) {
   /* implements a safer version of problem->evaluate(problem, x, y) */
   size_t i, j;
@@ -2770,6 +3464,7 @@ void coco_evaluate_function(coco_problem_t *problem, const double *x, double *y)
   
   assert(problem != NULL);
   assert(problem->evaluate_function != NULL);
+  coco_scratch_reserve();
   
   /* Set objective vector to INFINITY if the decision vector contains any INFINITY values */
   for (i = 0; i < coco_problem_get_dimension(problem); i++) {
@@ -2787,7 +3482,18 @@ void coco_evaluate_function(coco_problem_t *problem, const double *x, double *y)
     return;
   }
 
-  problem->evaluate_function(problem, x, y);
+  if (coco_evaluation_is_computed) { /* no bookkeeping, the loggers are skipped */
+    if (problem->is_logger)
+      coco_evaluate_function(coco_problem_transformed_get_inner_problem(problem), x, y);
+    else
+      problem->evaluate_function(problem, x, y);
+    return;
+  }
+
+  if (coco_evaluation_is_given && !problem->is_logger)
+    y[0] = coco_given_fvalue; /* the function itself is skipped, loggers still see the evaluation */
+  else
+    problem->evaluate_function(problem, x, y);
   problem->evaluations++; /* each derived class has its own counter, only the most outer will be visible */
 
   /* A little bit of bookkeeping */
@@ -2805,6 +3511,135 @@ void coco_evaluate_function(coco_problem_t *problem, const double *x, double *y)
   }
 }
 
+/**
+ * Records an evaluation of the problem in point x without evaluating the function: its value is given in y[0],
+ * computed beforehand by coco_compute_function() or by an identical problem (see coco_problem_clone()).
+ * Evaluation counters, best observed values and the output of observers are updated exactly as by
+ * coco_evaluate_function().
+ *
+ * @note Not reentrant, must be called from a single thread.
+ *
+ * @param problem The given COCO problem.
+ * @param x The decision vector.
+ * @param y The objective vector, holding the function value in x.
+ */
+void coco_evaluate_function_given(coco_problem_t *problem, const double *x, double *y) {
+  assert(coco_problem_get_number_of_objectives(problem) == 1);
+  coco_given_fvalue = y[0];
+  coco_evaluation_is_given = 1;
+  coco_evaluate_function(problem, x, y);
+  coco_evaluation_is_given = 0;
+}
+
+/**
+ * Computes the function value of the problem in point x without recording the evaluation: no counter, best
+ * observed value or observer output changes. Unlike coco_evaluate_function(), it may be called by several
+ * threads at once on the same problem of the bbob suite, each transformation then working on buffers of its
+ * own. The computed value is recorded afterwards, from a single thread, by coco_evaluate_function_given().
+ *
+ * @param problem The given COCO problem.
+ * @param x The decision vector.
+ * @param y The objective vector that is the result of the computation.
+ */
+void coco_compute_function(coco_problem_t *problem, const double *x, double *y) {
+  coco_scratch_reserve();
+  coco_evaluation_is_computed = 1;
+  coco_evaluate_function(problem, x, y);
+  coco_evaluation_is_computed = 0;
+}
+
+/**
+ * Computes the function values of the problem in n points at once, laid out as in coco_evaluate_function_batch(),
+ * without recording the evaluations. Like coco_compute_function(), it may be called by several threads at once.
+ *
+ * @param problem The given COCO problem.
+ * @param x The n decision vectors.
+ * @param n The number of points.
+ * @param y The n objective values.
+ */
+void coco_compute_function_batch(coco_problem_t *problem, const double *x, const size_t n, double *y) {
+  coco_scratch_reserve();
+  coco_evaluation_is_computed = 1;
+  coco_evaluate_function_batch(problem, x, n, y);
+  coco_evaluation_is_computed = 0;
+}
+
+/**
+ * @brief Evaluates the problem function in a batch of points without any bookkeeping at this level.
+ */
+static void coco_problem_evaluate_function_batch(coco_problem_t *problem, const double *x, const size_t n, double *y) {
+  size_t k;
+  if (problem->evaluate_function_batch != NULL) {
+    problem->evaluate_function_batch(problem, x, n, y);
+    return;
+  }
+  for (k = 0; k < n; k++)
+    problem->evaluate_function(problem, x + k * problem->number_of_variables, y + k);
+}
+
+/**
+ * Evaluates the problem function in n points at once. The points are stored one after the other in x, the k-th
+ * starting at x + k * dimension, and the k-th function value is saved in y[k]. Each transformation implementing
+ * evaluate_function_batch transforms the whole batch before passing it on to its inner problem, so the chain of
+ * a bbob problem is traversed once per batch instead of once per point. Evaluation counters, best observed
+ * values and the output of observers are updated exactly as by n calls of coco_evaluate_function().
+ *
+ * @note Multi-objective and constrained problems, and batches with INFINITY or NAN values, are evaluated
+ * point by point with coco_evaluate_function().
+ *
+ * @param problem The given COCO problem.
+ * @param x The n decision vectors.
+ * @param n The number of points.
+ * @param y The n objective values.
+ */
+void coco_evaluate_function_batch(coco_problem_t *problem, const double *x, const size_t n, double *y) {
+  size_t i, k;
+  int is_regular;
+  const size_t dimension = coco_problem_get_dimension(problem);
+
+  assert(problem != NULL);
+  assert(problem->evaluate_function != NULL);
+  if (n == 0)
+    return;
+  coco_scratch_reserve();
+  while (coco_evaluation_is_computed && problem->is_logger)
+    problem = coco_problem_transformed_get_inner_problem(problem);
+
+  is_regular = coco_problem_get_number_of_objectives(problem) == 1
+      && coco_problem_get_number_of_constraints(problem) == 0 && !coco_evaluation_is_given;
+  for (i = 0; i < n * dimension && is_regular; i++) {
+    if (coco_is_inf(x[i]) || coco_is_nan(x[i]))
+      is_regular = 0;
+  }
+  if (is_regular && problem->is_logger && coco_problem_transformed_get_inner_problem(problem)->is_logger)
+    is_regular = 0;
+  if (!is_regular) {
+    for (k = 0; k < n; k++)
+      coco_evaluate_function(problem, x + k * dimension, y + k * coco_problem_get_number_of_objectives(problem));
+    return;
+  }
+
+  if (problem->is_logger) {
+    /* Loggers handle one point at a time: the values are computed in a batch below the logger, which then
+     * records them in order as given values */
+    coco_problem_evaluate_function_batch(coco_problem_transformed_get_inner_problem(problem), x, n, y);
+    for (k = 0; k < n; k++)
+      coco_evaluate_function_given(problem, x + k * dimension, y + k);
+    return;
+  }
+
+  coco_problem_evaluate_function_batch(problem, x, n, y);
+  if (coco_evaluation_is_computed)
+    return;
+  for (k = 0; k < n; k++) {
+    problem->evaluations++;
+    if (y[k] < problem->best_observed_fvalue[0]) {
+      problem->best_observed_fvalue[0] = y[k];
+      problem->best_observed_evaluation[0] = problem->evaluations;
+    }
+  }
+}
+
 /**
  * Evaluates the problem constraint.
  * 
@@ -2896,6 +3731,7 @@ static coco_problem_t *coco_problem_allocate(const size_t number_of_variables,
   problem->evaluate_function = NULL;
   problem->evaluate_constraint = NULL;
   problem->evaluate_gradient = NULL;
+  problem->evaluate_function_batch = NULL;
   problem->recommend_solution = NULL;
   problem->problem_free_function = NULL;
   problem->number_of_variables = number_of_variables;
@@ -2929,6 +3765,7 @@ static coco_problem_t *coco_problem_allocate(const size_t number_of_variables,
   problem->suite_dep_instance = 0;
   problem->data = NULL;
   problem->versatile_data = NULL; /* Wassim: added to be able to pass data from one transformation to another*/
+  problem->is_logger = 0;
   return problem;
 }
 
@@ -2943,6 +3780,7 @@ static coco_problem_t *coco_problem_duplicate(const coco_problem_t *other) {
 
   problem->evaluate_function = other->evaluate_function;
   problem->evaluate_constraint = other->evaluate_constraint;
+  problem->evaluate_function_batch = other->evaluate_function_batch;
   problem->recommend_solution = other->recommend_solution;
   problem->problem_free_function = other->problem_free_function;
   
@@ -3336,6 +4174,22 @@ static size_t coco_problem_get_suite_dep_instance(const coco_problem_t *problem)
   assert(problem->suite_dep_instance > 0);
   return problem->suite_dep_instance;
 }
+/**
+ * Creates the same problem anew from its suite, without any observer. Problems keep internal work buffers,
+ * so a problem must not be evaluated concurrently: each thread evaluates its own clone instead.
+ *
+ * @note The suite of the problem must still exist.
+ *
+ * @return The clone, to be freed with coco_problem_free().
+ */
+coco_problem_t *coco_problem_clone(const coco_problem_t *problem) {
+  coco_problem_t *clone = coco_suite_get_problem_by_function_dimension_instance(coco_problem_get_suite(problem),
+      coco_problem_get_suite_dep_function(problem), coco_problem_get_dimension(problem),
+      coco_problem_get_suite_dep_instance(problem));
+  if (clone == NULL)
+    coco_error("coco_problem_clone(): cannot recreate problem %s", coco_problem_get_id(problem));
+  return clone;
+}
 /**@}*/
 
 void bbob_problem_best_parameter_print(const coco_problem_t *problem) {
@@ -3518,6 +4372,7 @@ static coco_problem_t *coco_problem_transformed_allocate(coco_problem_t *inner_p
   inner_copy->evaluate_function = coco_problem_transformed_evaluate_function;
   inner_copy->evaluate_constraint = coco_problem_transformed_evaluate_constraint;
   inner_copy->evaluate_gradient = bbob_problem_transformed_evaluate_gradient;
+  inner_copy->evaluate_function_batch = NULL; /* Transformations that set evaluate_function may set it, too */
   inner_copy->recommend_solution = coco_problem_transformed_recommend_solution;
   inner_copy->problem_free_function = coco_problem_transformed_free;
   inner_copy->data = problem;
@@ -3968,6 +4823,27 @@ static void transform_obj_oscillate_evaluate(coco_problem_t *problem, const doub
   assert(y[0] + 1e-13 >= problem->best_value[0]);
 }
 
+/**
+ * @brief Evaluates the transformed function in a batch of points.
+ */
+static void transform_obj_oscillate_evaluate_batch(coco_problem_t *problem, const double *x, const size_t n, double *y) {
+  size_t k;
+  static const double factor = 0.1;
+
+  coco_evaluate_function_batch(coco_problem_transformed_get_inner_problem(problem), x, n, y);
+  for (k = 0; k < n; k++) {
+    if (y[k] != 0) {
+      const double log_y = log(fabs(y[k])) / factor;
+      if (y[k] > 0) {
+        y[k] = pow(exp(log_y + 0.49 * (sin(log_y) + sin(0.79 * log_y))), factor);
+      } else {
+        y[k] = -pow(exp(log_y + 0.49 * (sin(0.55 * log_y) + sin(0.31 * log_y))), factor);
+      }
+    }
+    assert(y[k] + 1e-13 >= problem->best_value[0]);
+  }
+}
+
 /**
  * @brief Creates the transformation.
  */
@@ -3975,6 +4851,7 @@ static coco_problem_t *transform_obj_oscillate(coco_problem_t *inner_problem) {
   coco_problem_t *problem;
   problem = coco_problem_transformed_allocate(inner_problem, NULL, NULL, "transform_obj_oscillate");
   problem->evaluate_function = transform_obj_oscillate_evaluate;
+  problem->evaluate_function_batch = transform_obj_oscillate_evaluate_batch;
   /* Compute best value */
   /* Maybe not the most efficient solution */
   transform_obj_oscillate_evaluate(problem, problem->best_parameter, problem->best_value);
@@ -4021,6 +4898,20 @@ static void transform_obj_power_evaluate(coco_problem_t *problem, const double *
   assert(y[0] + 1e-13 >= problem->best_value[0]);
 }
 
+/**
+ * @brief Evaluates the transformed function in a batch of points.
+ */
+static void transform_obj_power_evaluate_batch(coco_problem_t *problem, const double *x, const size_t n, double *y) {
+  size_t k;
+  transform_obj_power_data_t *data = (transform_obj_power_data_t *) coco_problem_transformed_get_data(problem);
+
+  coco_evaluate_function_batch(coco_problem_transformed_get_inner_problem(problem), x, n, y);
+  for (k = 0; k < n; k++) {
+    y[k] = pow(y[k], data->exponent);
+    assert(y[k] + 1e-13 >= problem->best_value[0]);
+  }
+}
+
 /**
  * @brief Creates the transformation.
  */
@@ -4033,6 +4924,7 @@ static coco_problem_t *transform_obj_power(coco_problem_t *inner_problem, const
 
   problem = coco_problem_transformed_allocate(inner_problem, data, NULL, "transform_obj_power");
   problem->evaluate_function = transform_obj_power_evaluate;
+  problem->evaluate_function_batch = transform_obj_power_evaluate_batch;
   /* Compute best value */
   transform_obj_power_evaluate(problem, problem->best_parameter, problem->best_value);
   return problem;
@@ -4086,6 +4978,20 @@ static void transform_obj_shift_evaluate_function(coco_problem_t *problem, const
   else assert(y[0] + 1e-13 >= problem->best_value[0]);
 }
 
+/**
+ * @brief Evaluates the transformed function in a batch of points.
+ */
+static void transform_obj_shift_evaluate_batch(coco_problem_t *problem, const double *x, const size_t n, double *y) {
+  size_t k;
+  transform_obj_shift_data_t *data = (transform_obj_shift_data_t *) coco_problem_transformed_get_data(problem);
+
+  coco_evaluate_function_batch(coco_problem_transformed_get_inner_problem(problem), x, n, y);
+  for (k = 0; k < n; k++) {
+    y[k] += data->offset;
+    assert(y[k] + 1e-13 >= problem->best_value[0]);
+  }
+}
+
 /**
  * @brief Evaluates the gradient of the transformed function at x
  */
@@ -4112,8 +5018,10 @@ static coco_problem_t *transform_obj_shift(coco_problem_t *inner_problem, const
   problem = coco_problem_transformed_allocate(inner_problem, data, 
     NULL, "transform_obj_shift");
     
-  if (inner_problem->number_of_objectives > 0)
+  if (inner_problem->number_of_objectives > 0) {
     problem->evaluate_function = transform_obj_shift_evaluate_function;
+    problem->evaluate_function_batch = transform_obj_shift_evaluate_batch;
+  }
     
   problem->evaluate_gradient = transform_obj_shift_evaluate_gradient;  /* TODO (NH): why do we need a new function pointer here? */
   
@@ -4147,14 +5055,14 @@ static coco_problem_t *transform_obj_shift(coco_problem_t *inner_problem, const
  */
 typedef struct {
   double *M, *b, *x;
+  double *Mt; /**< @brief The transpose of M, read by the vectorized kernels of coco_simd_affine() */
 } transform_vars_affine_data_t;
 
 /**
  * @brief Evaluates the transformed objective function.
  */
 static void transform_vars_affine_evaluate_function(coco_problem_t *problem, const double *x, double *y) {
-  size_t i, j;
-  double *cons_values;
+  double *transformed_x, *cons_values;
   int is_feasible;
   transform_vars_affine_data_t *data;
   coco_problem_t *inner_problem;
@@ -4167,16 +5075,13 @@ static void transform_vars_affine_evaluate_function(coco_problem_t *problem, con
   data = (transform_vars_affine_data_t *) coco_problem_transformed_get_data(problem);
   inner_problem = coco_problem_transformed_get_inner_problem(problem);
 
-  for (i = 0; i < inner_problem->number_of_variables; ++i) {
-    /* data->M has problem->number_of_variables columns and inner_problem->number_of_variables rows. */
-    const double *current_row = data->M + i * problem->number_of_variables;
-    data->x[i] = data->b[i];
-    for (j = 0; j < problem->number_of_variables; ++j) {
-      data->x[i] += x[j] * current_row[j];
-    }
-  }
+  /* data->M has problem->number_of_variables columns and inner_problem->number_of_variables rows. */
+  transformed_x = coco_scratch_get(data->x, inner_problem->number_of_variables);
+  coco_simd_affine(data->M, data->Mt, data->b, x, transformed_x, inner_problem->number_of_variables,
+      problem->number_of_variables, 1);
   
-  coco_evaluate_function(inner_problem, data->x, y);
+  coco_evaluate_function(inner_problem, transformed_x, y);
+  coco_scratch_release(transformed_x, data->x);
   
   if (problem->number_of_constraints > 0) {
     cons_values = coco_allocate_vector(problem->number_of_constraints);
@@ -4188,6 +5093,23 @@ static void transform_vars_affine_evaluate_function(coco_problem_t *problem, con
   else assert(y[0] + 1e-13 >= problem->best_value[0]);
 }
 
+/**
+ * @brief Evaluates the transformed function in a batch of points, transforming all of them at once.
+ */
+static void transform_vars_affine_evaluate_batch(coco_problem_t *problem, const double *x, const size_t n, double *y) {
+  size_t k;
+  transform_vars_affine_data_t *data = (transform_vars_affine_data_t *) coco_problem_transformed_get_data(problem);
+  coco_problem_t *inner_problem = coco_problem_transformed_get_inner_problem(problem);
+  double *transformed_x = coco_scratch_take(n * inner_problem->number_of_variables);
+
+  coco_simd_affine(data->M, data->Mt, data->b, x, transformed_x, inner_problem->number_of_variables,
+      problem->number_of_variables, n);
+  coco_evaluate_function_batch(inner_problem, transformed_x, n, y);
+  coco_scratch_release(transformed_x, NULL);
+  for (k = 0; k < n; k++)
+    assert(y[k] + 1e-13 >= problem->best_value[0]);
+}
+
 /**
  * @brief Evaluates the transformed constraint.
  */
@@ -4274,6 +5196,7 @@ static void transform_vars_affine_free(void *thing) {
   coco_free_memory(data->M);
   coco_free_memory(data->b);
   coco_free_memory(data->x);
+  coco_free_memory(data->Mt);
 }
 
 /**
@@ -4299,12 +5222,18 @@ static coco_problem_t *transform_vars_affine(coco_problem_t *inner_problem,
   data->M = coco_duplicate_vector(M, entries_in_M);
   data->b = coco_duplicate_vector(b, inner_problem->number_of_variables);
   data->x = coco_allocate_vector(inner_problem->number_of_variables);
+  data->Mt = coco_allocate_vector(entries_in_M);
+  for (i = 0; i < inner_problem->number_of_variables; ++i)
+    for (j = 0; j < number_of_variables; ++j)
+      data->Mt[j * inner_problem->number_of_variables + i] = M[i * number_of_variables + j];
 
   problem = coco_problem_transformed_allocate(inner_problem, data, 
     transform_vars_affine_free, "transform_vars_affine");
     
-  if (inner_problem->number_of_objectives > 0)
+  if (inner_problem->number_of_objectives > 0) {
     problem->evaluate_function = transform_vars_affine_evaluate_function;
+    problem->evaluate_function_batch = transform_vars_affine_evaluate_batch;
+  }
     
   if (inner_problem->number_of_constraints > 0)
     problem->evaluate_constraint = transform_vars_affine_evaluate_constraint;
@@ -4361,7 +5290,7 @@ typedef struct {
  */
 static void transform_vars_shift_evaluate_function(coco_problem_t *problem, const double *x, double *y) {
   size_t i;
-  double *cons_values;
+  double *shifted_x, *cons_values;
   int is_feasible;
   transform_vars_shift_data_t *data;
   coco_problem_t *inner_problem;
@@ -4374,11 +5303,13 @@ static void transform_vars_shift_evaluate_function(coco_problem_t *problem, cons
   data = (transform_vars_shift_data_t *) coco_problem_transformed_get_data(problem);
   inner_problem = coco_problem_transformed_get_inner_problem(problem);
 
+  shifted_x = coco_scratch_get(data->shifted_x, problem->number_of_variables);
   for (i = 0; i < problem->number_of_variables; ++i) {
-    data->shifted_x[i] = x[i] - data->offset[i];
+    shifted_x[i] = x[i] - data->offset[i];
   }
   
-  coco_evaluate_function(inner_problem, data->shifted_x, y);
+  coco_evaluate_function(inner_problem, shifted_x, y);
+  coco_scratch_release(shifted_x, data->shifted_x);
   
   if (problem->number_of_constraints > 0) {
     cons_values = coco_allocate_vector(problem->number_of_constraints);
@@ -4390,6 +5321,29 @@ static void transform_vars_shift_evaluate_function(coco_problem_t *problem, cons
   else assert(y[0] + 1e-13 >= problem->best_value[0]);
 }
 
+/**
+ * @brief Evaluates the transformed function in a batch of points, transforming all of them at once.
+ */
+static void transform_vars_shift_evaluate_batch(coco_problem_t *problem, const double *x, const size_t n, double *y) {
+  size_t i, k;
+  const size_t dimension = problem->number_of_variables;
+  transform_vars_shift_data_t *data = (transform_vars_shift_data_t *) coco_problem_transformed_get_data(problem);
+  coco_problem_t *inner_problem = coco_problem_transformed_get_inner_problem(problem);
+  double *transformed_x = coco_scratch_take(n * dimension);
+
+  for (k = 0; k < n; k++) {
+    const double *x_k = x + k * dimension;
+    double *z = transformed_x + k * dimension;
+    for (i = 0; i < dimension; ++i) {
+      z[i] = x_k[i] - data->offset[i];
+    }
+  }
+  coco_evaluate_function_batch(inner_problem, transformed_x, n, y);
+  coco_scratch_release(transformed_x, NULL);
+  for (k = 0; k < n; k++)
+    assert(y[k] + 1e-13 >= problem->best_value[0]);
+}
+
 /**
  * @brief Evaluates the transformed constraint function.
  */
@@ -4463,8 +5417,10 @@ static coco_problem_t *transform_vars_shift(coco_problem_t *inner_problem,
   problem = coco_problem_transformed_allocate(inner_problem, data, 
     transform_vars_shift_free, "transform_vars_shift");
     
-  if (inner_problem->number_of_objectives > 0)
+  if (inner_problem->number_of_objectives > 0) {
     problem->evaluate_function = transform_vars_shift_evaluate_function;
+    problem->evaluate_function_batch = transform_vars_shift_evaluate_batch;
+  }
     
   if (inner_problem->number_of_constraints > 0)
     problem->evaluate_constraint = transform_vars_shift_evaluate_constraint;
@@ -5130,6 +6086,7 @@ typedef struct {
  */
 static void transform_vars_conditioning_evaluate(coco_problem_t *problem, const double *x, double *y) {
   size_t i;
+  double *transformed_x;
   transform_vars_conditioning_data_t *data;
   coco_problem_t *inner_problem;
 
@@ -5141,17 +6098,42 @@ static void transform_vars_conditioning_evaluate(coco_problem_t *problem, const
   data = (transform_vars_conditioning_data_t *) coco_problem_transformed_get_data(problem);
   inner_problem = coco_problem_transformed_get_inner_problem(problem);
 
+  transformed_x = coco_scratch_get(data->x, problem->number_of_variables);
   for (i = 0; i < problem->number_of_variables; ++i) {
     /* OME: We could precalculate the scaling coefficients if we
      * really wanted to.
      */
-    data->x[i] = pow(data->alpha, 0.5 * (double) (long) i / ((double) (long) problem->number_of_variables - 1.0))
+    transformed_x[i] = pow(data->alpha, 0.5 * (double) (long) i / ((double) (long) problem->number_of_variables - 1.0))
         * x[i];
   }
-  coco_evaluate_function(inner_problem, data->x, y);
+  coco_evaluate_function(inner_problem, transformed_x, y);
+  coco_scratch_release(transformed_x, data->x);
   assert(y[0] + 1e-13 >= problem->best_value[0]);
 }
 
+/**
+ * @brief Evaluates the transformed function in a batch of points, transforming all of them at once.
+ */
+static void transform_vars_conditioning_evaluate_batch(coco_problem_t *problem, const double *x, const size_t n, double *y) {
+  size_t i, k;
+  const size_t dimension = problem->number_of_variables;
+  transform_vars_conditioning_data_t *data = (transform_vars_conditioning_data_t *) coco_problem_transformed_get_data(problem);
+  coco_problem_t *inner_problem = coco_problem_transformed_get_inner_problem(problem);
+  double *transformed_x = coco_scratch_take(n * dimension);
+
+  for (k = 0; k < n; k++) {
+    const double *x_k = x + k * dimension;
+    double *z = transformed_x + k * dimension;
+    for (i = 0; i < dimension; ++i) {
+      z[i] = pow(data->alpha, 0.5 * (double) (long) i / ((double) (long) dimension - 1.0)) * x_k[i];
+    }
+  }
+  coco_evaluate_function_batch(inner_problem, transformed_x, n, y);
+  coco_scratch_release(transformed_x, NULL);
+  for (k = 0; k < n; k++)
+    assert(y[k] + 1e-13 >= problem->best_value[0]);
+}
+
 /**
  * @brief Evaluates the gradient of the transformed function.
  */
@@ -5203,6 +6185,7 @@ static coco_problem_t *transform_vars_conditioning(coco_problem_t *inner_problem
   data->alpha = alpha;
   problem = coco_problem_transformed_allocate(inner_problem, data, transform_vars_conditioning_free, "transform_vars_conditioning");
   problem->evaluate_function = transform_vars_conditioning_evaluate;
+  problem->evaluate_function_batch = transform_vars_conditioning_evaluate_batch;
   problem->evaluate_gradient = transform_vars_conditioning_evaluate_gradient;
 
   if (coco_problem_best_parameter_not_zero(inner_problem)) {
@@ -5491,7 +6474,7 @@ static void transform_vars_asymmetric_evaluate_function(coco_problem_t *problem,
                                                         const double *x, 
                                                         double *y) {
   size_t i;
-  double exponent, *cons_values;
+  double exponent, *transformed_x, *cons_values;
   int is_feasible;
   transform_vars_asymmetric_data_t *data;
   coco_problem_t *inner_problem;
@@ -5504,17 +6487,19 @@ static void transform_vars_asymmetric_evaluate_function(coco_problem_t *problem,
   data = (transform_vars_asymmetric_data_t *) coco_problem_transformed_get_data(problem);
   inner_problem = coco_problem_transformed_get_inner_problem(problem);
 
+  transformed_x = coco_scratch_get(data->x, problem->number_of_variables);
   for (i = 0; i < problem->number_of_variables; ++i) {
     if (x[i] > 0.0) {
       exponent = 1.0
           + ((data->beta * (double) (long) i) / ((double) (long) problem->number_of_variables - 1.0)) * sqrt(x[i]);
-      data->x[i] = pow(x[i], exponent);
+      transformed_x[i] = pow(x[i], exponent);
     } else {
-      data->x[i] = x[i];
+      transformed_x[i] = x[i];
     }
   }
   
-  coco_evaluate_function(inner_problem, data->x, y);
+  coco_evaluate_function(inner_problem, transformed_x, y);
+  coco_scratch_release(transformed_x, data->x);
   
   if (problem->number_of_constraints > 0) {
     cons_values = coco_allocate_vector(problem->number_of_constraints);
@@ -5526,6 +6511,35 @@ static void transform_vars_asymmetric_evaluate_function(coco_problem_t *problem,
   else assert(y[0] + 1e-13 >= problem->best_value[0]);
 }
 
+/**
+ * @brief Evaluates the transformed function in a batch of points, transforming all of them at once.
+ */
+static void transform_vars_asymmetric_evaluate_batch(coco_problem_t *problem, const double *x, const size_t n, double *y) {
+  size_t i, k;
+  double exponent;
+  const size_t dimension = problem->number_of_variables;
+  transform_vars_asymmetric_data_t *data = (transform_vars_asymmetric_data_t *) coco_problem_transformed_get_data(problem);
+  coco_problem_t *inner_problem = coco_problem_transformed_get_inner_problem(problem);
+  double *transformed_x = coco_scratch_take(n * dimension);
+
+  for (k = 0; k < n; k++) {
+    const double *x_k = x + k * dimension;
+    double *z = transformed_x + k * dimension;
+    for (i = 0; i < dimension; ++i) {
+      if (x_k[i] > 0.0) {
+        exponent = 1.0 + ((data->beta * (double) (long) i) / ((double) (long) dimension - 1.0)) * sqrt(x_k[i]);
+        z[i] = pow(x_k[i], exponent);
+      } else {
+        z[i] = x_k[i];
+      }
+    }
+  }
+  coco_evaluate_function_batch(inner_problem, transformed_x, n, y);
+  coco_scratch_release(transformed_x, NULL);
+  for (k = 0; k < n; k++)
+    assert(y[k] + 1e-13 >= problem->best_value[0]);
+}
+
 /**
  * @brief Evaluates the transformed constraint.
  */
@@ -5579,8 +6593,10 @@ static coco_problem_t *transform_vars_asymmetric(coco_problem_t *inner_problem,
   problem = coco_problem_transformed_allocate(inner_problem, data, 
     transform_vars_asymmetric_free, "transform_vars_asymmetric");
     
-  if (inner_problem->number_of_objectives > 0)
+  if (inner_problem->number_of_objectives > 0) {
     problem->evaluate_function = transform_vars_asymmetric_evaluate_function;
+    problem->evaluate_function_batch = transform_vars_asymmetric_evaluate_batch;
+  }
     
   if (inner_problem->number_of_constraints > 0) {
 	  
@@ -5619,16 +6635,12 @@ static coco_problem_t *transform_vars_asymmetric(coco_problem_t *inner_problem,
 static double f_bent_cigar_raw(const double *x, const size_t number_of_variables) {
 
   static const double condition = 1.0e6;
-  size_t i;
   double result;
   
   if (coco_vector_contains_nan(x, number_of_variables))
     return NAN;
 
-  result = x[0] * x[0];
-  for (i = 1; i < number_of_variables; ++i) {
-    result += condition * x[i] * x[i];
-  }
+  result = coco_simd_sum_of_scaled_squares(x + 1, number_of_variables - 1, condition, x[0] * x[0]);
   return result;
 }
 
@@ -5791,7 +6803,7 @@ typedef struct {
  */
 static void transform_vars_brs_evaluate(coco_problem_t *problem, const double *x, double *y) {
   size_t i;
-  double factor;
+  double factor, *transformed_x;
   transform_vars_brs_data_t *data;
   coco_problem_t *inner_problem;
 
@@ -5803,6 +6815,7 @@ static void transform_vars_brs_evaluate(coco_problem_t *problem, const double *x
   data = (transform_vars_brs_data_t *) coco_problem_transformed_get_data(problem);
   inner_problem = coco_problem_transformed_get_inner_problem(problem);
 
+  transformed_x = coco_scratch_get(data->x, problem->number_of_variables);
   for (i = 0; i < problem->number_of_variables; ++i) {
     /* Function documentation says we should compute 10^(0.5 *
      * (i-1)/(D-1)). Instead we compute the equivalent
@@ -5816,12 +6829,40 @@ static void transform_vars_brs_evaluate(coco_problem_t *problem, const double *x
     if (x[i] > 0.0 && i % 2 == 0) {
       factor *= 10.0;
     }
-    data->x[i] = factor * x[i];
+    transformed_x[i] = factor * x[i];
   }
-  coco_evaluate_function(inner_problem, data->x, y);
+  coco_evaluate_function(inner_problem, transformed_x, y);
+  coco_scratch_release(transformed_x, data->x);
   assert(y[0] + 1e-13 >= problem->best_value[0]);
 }
 
+/**
+ * @brief Evaluates the transformed function in a batch of points, transforming all of them at once.
+ */
+static void transform_vars_brs_evaluate_batch(coco_problem_t *problem, const double *x, const size_t n, double *y) {
+  size_t i, k;
+  double factor;
+  const size_t dimension = problem->number_of_variables;
+  coco_problem_t *inner_problem = coco_problem_transformed_get_inner_problem(problem);
+  double *transformed_x = coco_scratch_take(n * dimension);
+
+  for (k = 0; k < n; k++) {
+    const double *x_k = x + k * dimension;
+    double *z = transformed_x + k * dimension;
+    for (i = 0; i < dimension; ++i) {
+      factor = pow(sqrt(10.0), (double) (long) i / ((double) (long) dimension - 1.0));
+      if (x_k[i] > 0.0 && i % 2 == 0) {
+        factor *= 10.0;
+      }
+      z[i] = factor * x_k[i];
+    }
+  }
+  coco_evaluate_function_batch(inner_problem, transformed_x, n, y);
+  coco_scratch_release(transformed_x, NULL);
+  for (k = 0; k < n; k++)
+    assert(y[k] + 1e-13 >= problem->best_value[0]);
+}
+
 /**
  * @brief Frees the data object.
  */
@@ -5841,6 +6882,7 @@ static coco_problem_t *transform_vars_brs(coco_problem_t *inner_problem) {
   data->x = coco_allocate_vector(inner_problem->number_of_variables);
   problem = coco_problem_transformed_allocate(inner_problem, data, transform_vars_brs_free, "transform_vars_brs");
   problem->evaluate_function = transform_vars_brs_evaluate;
+  problem->evaluate_function_batch = transform_vars_brs_evaluate_batch;
 
   if (coco_problem_best_parameter_not_zero(inner_problem)) {
     coco_warning("transform_vars_brs(): 'best_parameter' not updated, set to NAN");
@@ -5885,7 +6927,7 @@ static void transform_vars_oscillate_evaluate_function(coco_problem_t *problem,
   }
 
   data = (transform_vars_oscillate_data_t *) coco_problem_transformed_get_data(problem);
-  oscillated_x = data->oscillated_x; /* short cut to make code more readable */
+  oscillated_x = coco_scratch_get(data->oscillated_x, problem->number_of_variables);
   inner_problem = coco_problem_transformed_get_inner_problem(problem);
 
   for (i = 0; i < problem->number_of_variables; ++i) {
@@ -5902,6 +6944,7 @@ static void transform_vars_oscillate_evaluate_function(coco_problem_t *problem,
     }
   }
   coco_evaluate_function(inner_problem, oscillated_x, y);
+  coco_scratch_release(oscillated_x, data->oscillated_x);
   
   if (problem->number_of_constraints > 0) {
     cons_values = coco_allocate_vector(problem->number_of_constraints);
@@ -5913,6 +6956,40 @@ static void transform_vars_oscillate_evaluate_function(coco_problem_t *problem,
   else assert(y[0] + 1e-13 >= problem->best_value[0]);
 }
 
+/**
+ * @brief Evaluates the transformed function in a batch of points, transforming all of them at once.
+ */
+static void transform_vars_oscillate_evaluate_batch(coco_problem_t *problem, const double *x, const size_t n, double *y) {
+  size_t i, k;
+  static const double alpha = 0.1;
+  double tmp, base;
+  const size_t dimension = problem->number_of_variables;
+  coco_problem_t *inner_problem = coco_problem_transformed_get_inner_problem(problem);
+  double *transformed_x = coco_scratch_take(n * dimension);
+
+  for (k = 0; k < n; k++) {
+    const double *x_k = x + k * dimension;
+    double *z = transformed_x + k * dimension;
+    for (i = 0; i < dimension; ++i) {
+      if (x_k[i] > 0.0) {
+        tmp = log(x_k[i]) / alpha;
+        base = exp(tmp + 0.49 * (sin(tmp) + sin(0.79 * tmp)));
+        z[i] = pow(base, alpha);
+      } else if (x_k[i] < 0.0) {
+        tmp = log(-x_k[i]) / alpha;
+        base = exp(tmp + 0.49 * (sin(0.55 * tmp) + sin(0.31 * tmp)));
+        z[i] = -pow(base, alpha);
+      } else {
+        z[i] = 0.0;
+      }
+    }
+  }
+  coco_evaluate_function_batch(inner_problem, transformed_x, n, y);
+  coco_scratch_release(transformed_x, NULL);
+  for (k = 0; k < n; k++)
+    assert(y[k] + 1e-13 >= problem->best_value[0]);
+}
+
 /**
  * @brief Evaluates the transformed constraints.
  */
@@ -5972,8 +7049,10 @@ static coco_problem_t *transform_vars_oscillate(coco_problem_t *inner_problem) {
   problem = coco_problem_transformed_allocate(inner_problem, data, 
     transform_vars_oscillate_free, "transform_vars_oscillate");
     
-  if (inner_problem->number_of_objectives > 0)
+  if (inner_problem->number_of_objectives > 0) {
     problem->evaluate_function = transform_vars_oscillate_evaluate_function;
+    problem->evaluate_function_batch = transform_vars_oscillate_evaluate_batch;
+  }
     
   if (inner_problem->number_of_constraints > 0) {
     problem->evaluate_constraint = transform_vars_oscillate_evaluate_constraint;
@@ -6053,6 +7132,38 @@ static void transform_obj_penalize_evaluate(coco_problem_t *problem, const doubl
   assert(y[0] + 1e-13 >= problem->best_value[0]);
 }
 
+/**
+ * @brief Evaluates the transformation in a batch of points.
+ */
+static void transform_obj_penalize_evaluate_batch(coco_problem_t *problem, const double *x, const size_t n, double *y) {
+  transform_obj_penalize_data_t *data = (transform_obj_penalize_data_t *) coco_problem_transformed_get_data(problem);
+  const double *lower_bounds = problem->smallest_values_of_interest;
+  const double *upper_bounds = problem->largest_values_of_interest;
+  const size_t dimension = problem->number_of_variables;
+  double *penalty = coco_scratch_take(n);
+  size_t i, k;
+
+  for (k = 0; k < n; k++) {
+    const double *x_k = x + k * dimension;
+    penalty[k] = 0.0;
+    for (i = 0; i < dimension; ++i) {
+      const double c1 = x_k[i] - upper_bounds[i];
+      const double c2 = lower_bounds[i] - x_k[i];
+      if (c1 > 0.0) {
+        penalty[k] += c1 * c1;
+      } else if (c2 > 0.0) {
+        penalty[k] += c2 * c2;
+      }
+    }
+  }
+  coco_evaluate_function_batch(coco_problem_transformed_get_inner_problem(problem), x, n, y);
+  for (k = 0; k < n; k++) {
+    y[k] += data->factor * penalty[k];
+    assert(y[k] + 1e-13 >= problem->best_value[0]);
+  }
+  coco_scratch_release(penalty, NULL);
+}
+
 /**
  * @brief Creates the transformation.
  */
@@ -6065,6 +7176,7 @@ static coco_problem_t *transform_obj_penalize(coco_problem_t *inner_problem, con
   data->factor = factor;
   problem = coco_problem_transformed_allocate(inner_problem, data, NULL, "transform_obj_penalize");
   problem->evaluate_function = transform_obj_penalize_evaluate;
+  problem->evaluate_function_batch = transform_obj_penalize_evaluate_batch;
   /* No need to update the best value as the best parameter is feasible */
   return problem;
 }
@@ -6077,17 +7189,13 @@ static coco_problem_t *transform_obj_penalize(coco_problem_t *inner_problem, con
 static double f_bueche_rastrigin_raw(const double *x, const size_t number_of_variables) {
 
   double tmp = 0., tmp2 = 0.;
-  size_t i;
   double result;
 
   if (coco_vector_contains_nan(x, number_of_variables))
   	return NAN;
 
-  result = 0.0;
-  for (i = 0; i < number_of_variables; ++i) {
-    tmp += cos(2 * coco_pi * x[i]);
-    tmp2 += x[i] * x[i];
-  }
+  tmp = coco_simd_sum_of_cosines(x, number_of_variables, 2 * coco_pi);
+  tmp2 = coco_simd_sum_of_scaled_squares(x, number_of_variables, 1.0, 0.0);
   result = 10.0 * ((double) (long) number_of_variables - tmp) + tmp2 + 0;
   return result;
 }
@@ -6183,17 +7291,13 @@ static coco_problem_t *f_bueche_rastrigin_bbob_problem_allocate(const size_t fun
  */
 static double f_different_powers_raw(const double *x, const size_t number_of_variables) {
 
-  size_t i;
   double sum = 0.0;
   double result;
   
   if (coco_vector_contains_nan(x, number_of_variables))
     return NAN;
     
-  for (i = 0; i < number_of_variables; ++i) {
-    double exponent = 2.0 + (4.0 * (double) (long) i) / ((double) (long) number_of_variables - 1.0);
-    sum += pow(fabs(x[i]), exponent);
-  }
+  sum = coco_simd_sum_of_different_powers(x, number_of_variables);
   result = sqrt(sum);
 
   return result;
@@ -6445,6 +7549,7 @@ static double f_discus_raw(const double *x, const size_t number_of_variables) {
   if (coco_vector_contains_nan(x, number_of_variables))
     return NAN;
     
+  /* Scalar at every level: the vectorized sum of squares did not pay for itself on the discus */
   result = condition * x[0] * x[0];
   for (i = 1; i < number_of_variables; ++i) {
     result += x[i] * x[i];
@@ -6602,17 +7707,14 @@ static coco_problem_t *f_discus_cons_bbob_problem_allocate(const size_t function
 static double f_ellipsoid_raw(const double *x, const size_t number_of_variables) {
 
   static const double condition = 1.0e6;
-  size_t i = 0;
   double result;
     
   if (coco_vector_contains_nan(x, number_of_variables))
     return NAN;
 
-  result = x[i] * x[i];
-  for (i = 1; i < number_of_variables; ++i) {
-    const double exponent = 1.0 * (double) (long) i / ((double) (long) number_of_variables - 1.0);
-    result += pow(condition, exponent) * x[i] * x[i];
-  }
+  if (number_of_variables == 1)
+    return x[0] * x[0];
+  result = coco_simd_sum_of_conditioned_squares(x, number_of_variables, condition);
 
   return result;
 }
@@ -6905,6 +8007,7 @@ typedef struct {
  */
 static void transform_vars_scale_evaluate(coco_problem_t *problem, const double *x, double *y) {
   size_t i;
+  double *transformed_x;
   transform_vars_scale_data_t *data;
   coco_problem_t *inner_problem;
 
@@ -6918,14 +8021,39 @@ static void transform_vars_scale_evaluate(coco_problem_t *problem, const double
   do {
     const double factor = data->factor;
 
+    transformed_x = coco_scratch_get(data->x, problem->number_of_variables);
     for (i = 0; i < problem->number_of_variables; ++i) {
-      data->x[i] = factor * x[i];
+      transformed_x[i] = factor * x[i];
     }
-    coco_evaluate_function(inner_problem, data->x, y);
+    coco_evaluate_function(inner_problem, transformed_x, y);
+    coco_scratch_release(transformed_x, data->x);
     assert(y[0] + 1e-13 >= problem->best_value[0]);
   } while (0);
 }
 
+/**
+ * @brief Evaluates the transformed function in a batch of points, transforming all of them at once.
+ */
+static void transform_vars_scale_evaluate_batch(coco_problem_t *problem, const double *x, const size_t n, double *y) {
+  size_t i, k;
+  const size_t dimension = problem->number_of_variables;
+  transform_vars_scale_data_t *data = (transform_vars_scale_data_t *) coco_problem_transformed_get_data(problem);
+  coco_problem_t *inner_problem = coco_problem_transformed_get_inner_problem(problem);
+  double *transformed_x = coco_scratch_take(n * dimension);
+
+  for (k = 0; k < n; k++) {
+    const double *x_k = x + k * dimension;
+    double *z = transformed_x + k * dimension;
+    for (i = 0; i < dimension; ++i) {
+      z[i] = data->factor * x_k[i];
+    }
+  }
+  coco_evaluate_function_batch(inner_problem, transformed_x, n, y);
+  coco_scratch_release(transformed_x, NULL);
+  for (k = 0; k < n; k++)
+    assert(y[k] + 1e-13 >= problem->best_value[0]);
+}
+
 /**
  * @brief Frees the data object.
  */
@@ -6947,6 +8075,7 @@ static coco_problem_t *transform_vars_scale(coco_problem_t *inner_problem, const
 
   problem = coco_problem_transformed_allocate(inner_problem, data, transform_vars_scale_free, "transform_vars_scale");
   problem->evaluate_function = transform_vars_scale_evaluate;
+  problem->evaluate_function_batch = transform_vars_scale_evaluate_batch;
   /* Compute best parameter */
   if (data->factor != 0.) {
       for (i = 0; i < problem->number_of_variables; i++) {
@@ -6979,16 +8108,12 @@ static coco_problem_t *transform_vars_scale(coco_problem_t *inner_problem, const
  */
 static double f_sphere_raw(const double *x, const size_t number_of_variables) {
 
-  size_t i = 0;
   double result;
     
   if (coco_vector_contains_nan(x, number_of_variables))
     return NAN;
 
-  result = 0.0;
-  for (i = 0; i < number_of_variables; ++i) {
-    result += x[i] * x[i];
-  }
+  result = coco_simd_sum_of_scaled_squares(x, number_of_variables, 1.0, 0.0);
 
   return result;
 }
@@ -7249,7 +8374,7 @@ static double f_gallagher_raw(const double *x, const size_t number_of_variables,
   f_add = f_pen;
   /* Transformation in search space */
   /* TODO: this should rather be done in f_gallagher */
-  tmx = coco_allocate_vector(number_of_variables);
+  tmx = coco_scratch_take(number_of_variables);
   for (i = 0; i < number_of_variables; i++) {
     tmx[i] = 0;
     for (j = 0; j < number_of_variables; ++j) {
@@ -7280,7 +8405,7 @@ static double f_gallagher_raw(const double *x, const size_t number_of_variables,
   f_true *= f_true;
   f_true += f_add;
   result = f_true;
-  coco_free_memory(tmx);
+  coco_scratch_release(tmx, NULL);
   return result;
 }
 
@@ -7491,7 +8616,7 @@ static double f_gallagher_core(const double *x, size_t number_of_variables, f_ga
   size_t i,j;
   double maxf = DBL_MAX;
   double *x_local;
-  x_local = coco_allocate_vector(number_of_variables);
+  x_local = coco_scratch_take(number_of_variables);
 
 
   for (i = 0; i < versatile_data->number_of_peaks; i++) {
@@ -7511,7 +8636,7 @@ static double f_gallagher_core(const double *x, size_t number_of_variables, f_ga
     }
   }
   result = 10.0 - maxf;
-  coco_free_memory(x_local);
+  coco_scratch_release(x_local, NULL);
   return result;
 }
 
@@ -8451,6 +9576,20 @@ static void transform_obj_scale_evaluate_function(coco_problem_t *problem, const
   else assert(y[0] + 1e-13 >= problem->best_value[0]);
 }
 
+/**
+ * @brief Evaluates the transformed function in a batch of points.
+ */
+static void transform_obj_scale_evaluate_batch(coco_problem_t *problem, const double *x, const size_t n, double *y) {
+  size_t k;
+  transform_obj_scale_data_t *data = (transform_obj_scale_data_t *) coco_problem_transformed_get_data(problem);
+
+  coco_evaluate_function_batch(coco_problem_transformed_get_inner_problem(problem), x, n, y);
+  for (k = 0; k < n; k++) {
+    y[k] *= data->factor;
+    assert(y[k] + 1e-13 >= problem->best_value[0]);
+  }
+}
+
 /**
  * @brief Evaluates the gradient of the transformed function at x
  */
@@ -8484,8 +9623,10 @@ static coco_problem_t *transform_obj_scale(coco_problem_t *inner_problem, const
   problem = coco_problem_transformed_allocate(inner_problem, data,
     NULL, "transform_obj_scale");
 
-  if (inner_problem->number_of_objectives > 0)
+  if (inner_problem->number_of_objectives > 0) {
     problem->evaluate_function = transform_obj_scale_evaluate_function;
+    problem->evaluate_function_batch = transform_obj_scale_evaluate_batch;
+  }
 
   problem->evaluate_gradient = transform_obj_scale_evaluate_gradient;
 
@@ -8521,7 +9662,7 @@ static double f_lunacek_bi_rastrigin_raw(const double *x,
   static const double d = 1.;
   const double s = 1. - 0.5 / (sqrt((double) (number_of_variables + 20)) - 4.1);
   const double mu1 = -sqrt((mu0 * mu0 - d) / s);
-  double *tmpvect, sum1 = 0., sum2 = 0., sum3 = 0.;
+  double *tmpvect, *x_hat, *z, sum1 = 0., sum2 = 0., sum3 = 0.;
 
   assert(number_of_variables > 1);
 
@@ -8535,39 +9676,43 @@ static double f_lunacek_bi_rastrigin_raw(const double *x,
       penalty += tmp * tmp;
   }
 
+  x_hat = coco_scratch_get(data->x_hat, number_of_variables);
+  z = coco_scratch_get(data->z, number_of_variables);
   /* x_hat */
   for (i = 0; i < number_of_variables; ++i) {
-    data->x_hat[i] = 2. * x[i];
+    x_hat[i] = 2. * x[i];
     if (data->xopt[i] < 0.) {
-      data->x_hat[i] *= -1.;
+      x_hat[i] *= -1.;
     }
   }
 
-  tmpvect = coco_allocate_vector(number_of_variables);
+  tmpvect = coco_scratch_take(number_of_variables);
   /* affine transformation */
   for (i = 0; i < number_of_variables; ++i) {
     double c1;
     tmpvect[i] = 0.0;
     c1 = pow(sqrt(condition), ((double) i) / (double) (number_of_variables - 1));
     for (j = 0; j < number_of_variables; ++j) {
-      tmpvect[i] += c1 * data->rot2[i][j] * (data->x_hat[j] - mu0);
+      tmpvect[i] += c1 * data->rot2[i][j] * (x_hat[j] - mu0);
     }
   }
   for (i = 0; i < number_of_variables; ++i) {
-    data->z[i] = 0;
+    z[i] = 0;
     for (j = 0; j < number_of_variables; ++j) {
-      data->z[i] += data->rot1[i][j] * tmpvect[j];
+      z[i] += data->rot1[i][j] * tmpvect[j];
     }
   }
   /* Computation core */
   for (i = 0; i < number_of_variables; ++i) {
-    sum1 += (data->x_hat[i] - mu0) * (data->x_hat[i] - mu0);
-    sum2 += (data->x_hat[i] - mu1) * (data->x_hat[i] - mu1);
-    sum3 += cos(2 * coco_pi * data->z[i]);
+    sum1 += (x_hat[i] - mu0) * (x_hat[i] - mu0);
+    sum2 += (x_hat[i] - mu1) * (x_hat[i] - mu1);
+    sum3 += cos(2 * coco_pi * z[i]);
   }
   result = coco_double_min(sum1, d * (double) number_of_variables + s * sum2)
       + 10. * ((double) number_of_variables - sum3) + 1e4 * penalty;
-  coco_free_memory(tmpvect);
+  coco_scratch_release(tmpvect, NULL);
+  coco_scratch_release(x_hat, data->x_hat);
+  coco_scratch_release(z, data->z);
 
   return result;
 }
@@ -8932,17 +10077,14 @@ static coco_problem_t *f_lunacek_bi_rastrigin_permblockdiag_bbob_problem_allocat
  */
 static double f_rastrigin_raw(const double *x, const size_t number_of_variables) {
 
-  size_t i = 0;
   double result;
   double sum1 = 0.0, sum2 = 0.0;
     
   if (coco_vector_contains_nan(x, number_of_variables))
     return NAN;
 
-  for (i = 0; i < number_of_variables; ++i) {
-    sum1 += cos(coco_two_pi * x[i]);
-    sum2 += x[i] * x[i];
-  }
+  sum1 = coco_simd_sum_of_cosines(x, number_of_variables, coco_two_pi);
+  sum2 = coco_simd_sum_of_scaled_squares(x, number_of_variables, 1.0, 0.0);
   if (coco_is_inf(sum2)) /* cos(inf) -> nan */
     return sum2;
   result = 10.0 * ((double) (long) number_of_variables - sum1) + sum2;
@@ -9726,6 +10868,7 @@ typedef struct {
  */
 static void transform_vars_z_hat_evaluate(coco_problem_t *problem, const double *x, double *y) {
   size_t i;
+  double *transformed_x;
   transform_vars_z_hat_data_t *data;
   coco_problem_t *inner_problem;
 
@@ -9737,15 +10880,41 @@ static void transform_vars_z_hat_evaluate(coco_problem_t *problem, const double
   data = (transform_vars_z_hat_data_t *) coco_problem_transformed_get_data(problem);
   inner_problem = coco_problem_transformed_get_inner_problem(problem);
 
-  data->z[0] = x[0];
+  transformed_x = coco_scratch_get(data->z, problem->number_of_variables);
+  transformed_x[0] = x[0];
 
   for (i = 1; i < problem->number_of_variables; ++i) {
-    data->z[i] = x[i] + 0.25 * (x[i - 1] - 2.0 * fabs(data->xopt[i - 1]));
+    transformed_x[i] = x[i] + 0.25 * (x[i - 1] - 2.0 * fabs(data->xopt[i - 1]));
   }
-  coco_evaluate_function(inner_problem, data->z, y);
+  coco_evaluate_function(inner_problem, transformed_x, y);
+  coco_scratch_release(transformed_x, data->z);
   assert(y[0] + 1e-13 >= problem->best_value[0]);
 }
 
+/**
+ * @brief Evaluates the transformed function in a batch of points, transforming all of them at once.
+ */
+static void transform_vars_z_hat_evaluate_batch(coco_problem_t *problem, const double *x, const size_t n, double *y) {
+  size_t i, k;
+  const size_t dimension = problem->number_of_variables;
+  transform_vars_z_hat_data_t *data = (transform_vars_z_hat_data_t *) coco_problem_transformed_get_data(problem);
+  coco_problem_t *inner_problem = coco_problem_transformed_get_inner_problem(problem);
+  double *transformed_x = coco_scratch_take(n * dimension);
+
+  for (k = 0; k < n; k++) {
+    const double *x_k = x + k * dimension;
+    double *z = transformed_x + k * dimension;
+    z[0] = x_k[0];
+    for (i = 1; i < dimension; ++i) {
+      z[i] = x_k[i] + 0.25 * (x_k[i - 1] - 2.0 * fabs(data->xopt[i - 1]));
+    }
+  }
+  coco_evaluate_function_batch(inner_problem, transformed_x, n, y);
+  coco_scratch_release(transformed_x, NULL);
+  for (k = 0; k < n; k++)
+    assert(y[k] + 1e-13 >= problem->best_value[0]);
+}
+
 /**
  * @brief Frees the data object.
  */
@@ -9767,6 +10936,7 @@ static coco_problem_t *transform_vars_z_hat(coco_problem_t *inner_problem, const
 
   problem = coco_problem_transformed_allocate(inner_problem, data, transform_vars_z_hat_free, "transform_vars_z_hat");
   problem->evaluate_function = transform_vars_z_hat_evaluate;
+  problem->evaluate_function_batch = transform_vars_z_hat_evaluate_batch;
   /* TODO: implement best_parameter transformation if needed in the case of not zero:
      see also issue #814.
   The correct update of best_parameter seems not too difficult and should not anymore
@@ -9818,6 +10988,7 @@ typedef struct {
  */
 static void transform_vars_x_hat_evaluate(coco_problem_t *problem, const double *x, double *y) {
   size_t i;
+  double *transformed_x;
   transform_vars_x_hat_data_t *data;
   coco_problem_t *inner_problem;
 
@@ -9829,20 +11000,47 @@ static void transform_vars_x_hat_evaluate(coco_problem_t *problem, const double
  data = (transform_vars_x_hat_data_t *) coco_problem_transformed_get_data(problem);
   inner_problem = coco_problem_transformed_get_inner_problem(problem);
   do {
-    bbob2009_unif(data->x, problem->number_of_variables, data->seed);
+    transformed_x = coco_scratch_get(data->x, problem->number_of_variables);
+    bbob2009_unif(transformed_x, problem->number_of_variables, data->seed);
 
     for (i = 0; i < problem->number_of_variables; ++i) {
-      if (data->x[i] < 0.5) {
-        data->x[i] = -x[i];
+      if (transformed_x[i] < 0.5) {
+        transformed_x[i] = -x[i];
       } else {
-        data->x[i] = x[i];
+        transformed_x[i] = x[i];
       }
     }
-    coco_evaluate_function(inner_problem, data->x, y);
+    coco_evaluate_function(inner_problem, transformed_x, y);
+    coco_scratch_release(transformed_x, data->x);
     assert(y[0] + 1e-13 >= problem->best_value[0]);
   } while (0);
 }
 
+/**
+ * @brief Evaluates the transformed function in a batch of points, transforming all of them at once.
+ */
+static void transform_vars_x_hat_evaluate_batch(coco_problem_t *problem, const double *x, const size_t n, double *y) {
+  size_t i, k;
+  const size_t dimension = problem->number_of_variables;
+  transform_vars_x_hat_data_t *data = (transform_vars_x_hat_data_t *) coco_problem_transformed_get_data(problem);
+  coco_problem_t *inner_problem = coco_problem_transformed_get_inner_problem(problem);
+  double *transformed_x = coco_scratch_take(n * dimension);
+  double *signs = coco_scratch_get(data->x, dimension);
+  bbob2009_unif(signs, dimension, data->seed); /* The signs are drawn once for the whole batch */
+  for (k = 0; k < n; k++) {
+    const double *x_k = x + k * dimension;
+    double *z = transformed_x + k * dimension;
+    for (i = 0; i < dimension; ++i) {
+      z[i] = signs[i] < 0.5 ? -x_k[i] : x_k[i];
+    }
+  }
+  coco_scratch_release(signs, data->x);
+  coco_evaluate_function_batch(inner_problem, transformed_x, n, y);
+  coco_scratch_release(transformed_x, NULL);
+  for (k = 0; k < n; k++)
+    assert(y[k] + 1e-13 >= problem->best_value[0]);
+}
+
 /**
  * @brief Frees the data object.
  */
@@ -9865,6 +11063,7 @@ static coco_problem_t *transform_vars_x_hat(coco_problem_t *inner_problem, const
 
   problem = coco_problem_transformed_allocate(inner_problem, data, transform_vars_x_hat_free, "transform_vars_x_hat");
   problem->evaluate_function = transform_vars_x_hat_evaluate;
+  problem->evaluate_function_batch = transform_vars_x_hat_evaluate_batch;
   if (coco_problem_best_parameter_not_zero(problem)) {
     bbob2009_unif(data->x, problem->number_of_variables, data->seed);
 	for (i = 0; i < problem->number_of_variables; ++i)
@@ -10227,7 +11426,7 @@ static double f_step_ellipsoid_raw(const double *x, const size_t number_of_varia
   static const double condition = 100;
   static const double alpha = 10.0;
   size_t i, j;
-  double penalty = 0.0, x1;
+  double penalty = 0.0, x1, *rotated_x, *transformed_x;
   double result;
   
   assert(number_of_variables > 1);
@@ -10242,27 +11441,29 @@ static double f_step_ellipsoid_raw(const double *x, const size_t number_of_varia
       penalty += tmp * tmp;
   }
   
+  rotated_x = coco_scratch_get(data->x, number_of_variables);
+  transformed_x = coco_scratch_get(data->xx, number_of_variables);
   for (i = 0; i < number_of_variables; ++i) {
     double c1;
-    data->x[i] = 0.0;
+    rotated_x[i] = 0.0;
     c1 = sqrt(pow(condition / 10., (double) i / (double) (number_of_variables - 1)));
     for (j = 0; j < number_of_variables; ++j) {
-      data->x[i] += c1 * data->rot2[i][j] * (x[j] - data->xopt[j]);
+      rotated_x[i] += c1 * data->rot2[i][j] * (x[j] - data->xopt[j]);
     }
   }
-  x1 = data->x[0];
+  x1 = rotated_x[0];
   
   for (i = 0; i < number_of_variables; ++i) {
-    if (fabs(data->x[i]) > 0.5) /* TODO: Documentation: no fabs() in documentation */
-      data->x[i] = coco_double_round(data->x[i]);
+    if (fabs(rotated_x[i]) > 0.5) /* TODO: Documentation: no fabs() in documentation */
+      rotated_x[i] = coco_double_round(rotated_x[i]);
     else
-      data->x[i] = coco_double_round(alpha * data->x[i]) / alpha;
+      rotated_x[i] = coco_double_round(alpha * rotated_x[i]) / alpha;
   }
   
   for (i = 0; i < number_of_variables; ++i) {
-    data->xx[i] = 0.0;
+    transformed_x[i] = 0.0;
     for (j = 0; j < number_of_variables; ++j) {
-      data->xx[i] += data->rot1[i][j] * data->x[j];
+      transformed_x[i] += data->rot1[i][j] * rotated_x[j];
     }
   }
   
@@ -10271,10 +11472,12 @@ static double f_step_ellipsoid_raw(const double *x, const size_t number_of_varia
   for (i = 0; i < number_of_variables; ++i) {
     double exponent;
     exponent = (double) (long) i / ((double) (long) number_of_variables - 1.0);
-    result += pow(condition, exponent) * data->xx[i] * data->xx[i];
+    result += pow(condition, exponent) * transformed_x[i] * transformed_x[i];
     ;
   }
   result = 0.1 * coco_double_max(fabs(x1) * 1.0e-4, result) + penalty + data->fopt;
+  coco_scratch_release(rotated_x, data->x);
+  coco_scratch_release(transformed_x, data->xx);
   
   return result;
 }
@@ -10747,6 +11950,398 @@ static coco_problem_t *f_weierstrass_permblockdiag_bbob_problem_allocate(const s
 }
 
 #undef F_WEIERSTRASS_SUMMANDS
+#line 1 "code-experiments/src/transform_fused.c"
+/**
+ * @file transform_fused.c
+ * @brief Implementation of the fused evaluation of a stack of transformations.
+ *
+ * A bbob problem is a stack of transformations around a raw function, where every level checks its input,
+ * writes the transformed variables into its own buffer and calls the next level through
+ * coco_evaluate_function(). The fused transformation compiles the stack once, when the problem is
+ * constructed, into a flat list of operations that are applied in place to a single buffer, and calls only
+ * the innermost problem. Each operation performs the arithmetic of the transformation it replaces, in the
+ * same order, so the function values are identical to the ones of the stack. A batch of points passes
+ * through each operation together, the affine ones multiplying the matrix by all points at once.
+ */
+
+#include <assert.h>
+#include <math.h>
+
+#line 17 "code-experiments/src/transform_fused.c"
+
+/**
+ * @brief The transformations that can be fused, the ones of the variables come first.
+ */
+typedef enum {
+  TRANSFORM_FUSED_VARS_SHIFT, TRANSFORM_FUSED_VARS_AFFINE, TRANSFORM_FUSED_VARS_OSCILLATE,
+  TRANSFORM_FUSED_VARS_ASYMMETRIC, TRANSFORM_FUSED_VARS_CONDITIONING, TRANSFORM_FUSED_VARS_BRS,
+  TRANSFORM_FUSED_VARS_SCALE, TRANSFORM_FUSED_VARS_X_HAT, TRANSFORM_FUSED_VARS_Z_HAT,
+  TRANSFORM_FUSED_OBJ_SHIFT, TRANSFORM_FUSED_OBJ_SCALE, TRANSFORM_FUSED_OBJ_POWER,
+  TRANSFORM_FUSED_OBJ_OSCILLATE, TRANSFORM_FUSED_OBJ_PENALIZE, TRANSFORM_FUSED_NONE
+} transform_fused_kind_t;
+
+/**
+ * @brief One operation of the fused transformation.
+ */
+typedef struct {
+  transform_fused_kind_t kind;
+  coco_problem_t *problem;  /**< @brief The replaced level of the stack, which keeps owning its data */
+  double *coefficients;     /**< @brief Per variable constants computed at construction, or NULL */
+} transform_fused_operation_t;
+
+/**
+ * @brief Data type for transform_fused.
+ */
+typedef struct {
+  transform_fused_operation_t *operations; /**< @brief From the outermost level inwards */
+  size_t number_of_operations;
+  coco_problem_t *innermost;               /**< @brief The first level that is not fused */
+  double *buffer;                          /**< @brief The variables, the output of affine operations and
+                                                the penalties of an evaluation */
+} transform_fused_data_t;
+
+/**
+ * @brief Returns the kind of the transformation of the problem, TRANSFORM_FUSED_NONE if it cannot be fused.
+ */
+static transform_fused_kind_t transform_fused_get_kind(const coco_problem_t *problem) {
+  if (problem->evaluate_function == transform_vars_shift_evaluate_function)
+    return TRANSFORM_FUSED_VARS_SHIFT;
+  if (problem->evaluate_function == transform_vars_affine_evaluate_function)
+    return TRANSFORM_FUSED_VARS_AFFINE;
+  if (problem->evaluate_function == transform_vars_oscillate_evaluate_function)
+    return TRANSFORM_FUSED_VARS_OSCILLATE;
+  if (problem->evaluate_function == transform_vars_asymmetric_evaluate_function)
+    return TRANSFORM_FUSED_VARS_ASYMMETRIC;
+  if (problem->evaluate_function == transform_vars_conditioning_evaluate)
+    return TRANSFORM_FUSED_VARS_CONDITIONING;
+  if (problem->evaluate_function == transform_vars_brs_evaluate)
+    return TRANSFORM_FUSED_VARS_BRS;
+  if (problem->evaluate_function == transform_vars_scale_evaluate)
+    return TRANSFORM_FUSED_VARS_SCALE;
+  if (problem->evaluate_function == transform_vars_x_hat_evaluate)
+    return TRANSFORM_FUSED_VARS_X_HAT;
+  if (problem->evaluate_function == transform_vars_z_hat_evaluate)
+    return TRANSFORM_FUSED_VARS_Z_HAT;
+  if (problem->evaluate_function == transform_obj_shift_evaluate_function)
+    return TRANSFORM_FUSED_OBJ_SHIFT;
+  if (problem->evaluate_function == transform_obj_scale_evaluate_function)
+    return TRANSFORM_FUSED_OBJ_SCALE;
+  if (problem->evaluate_function == transform_obj_power_evaluate)
+    return TRANSFORM_FUSED_OBJ_POWER;
+  if (problem->evaluate_function == transform_obj_oscillate_evaluate)
+    return TRANSFORM_FUSED_OBJ_OSCILLATE;
+  if (problem->evaluate_function == transform_obj_penalize_evaluate)
+    return TRANSFORM_FUSED_OBJ_PENALIZE;
+  return TRANSFORM_FUSED_NONE;
+}
+
+/**
+ * @brief Computes the per variable constants of an operation, which the transformation recomputes in
+ * every evaluation.
+ */
+static double *transform_fused_coefficients(const transform_fused_kind_t kind, coco_problem_t *problem) {
+  const size_t n = problem->number_of_variables;
+  double *coefficients;
+  size_t i;
+
+  if (kind == TRANSFORM_FUSED_VARS_ASYMMETRIC) {
+    transform_vars_asymmetric_data_t *data;
+    data = (transform_vars_asymmetric_data_t *) coco_problem_transformed_get_data(problem);
+    coefficients = coco_allocate_vector(n);
+    for (i = 0; i < n; ++i)
+      coefficients[i] = (data->beta * (double) (long) i) / ((double) (long) n - 1.0);
+  } else if (kind == TRANSFORM_FUSED_VARS_CONDITIONING) {
+    transform_vars_conditioning_data_t *data;
+    data = (transform_vars_conditioning_data_t *) coco_problem_transformed_get_data(problem);
+    coefficients = coco_allocate_vector(n);
+    for (i = 0; i < n; ++i)
+      coefficients[i] = pow(data->alpha, 0.5 * (double) (long) i / ((double) (long) n - 1.0));
+  } else if (kind == TRANSFORM_FUSED_VARS_BRS) {
+    coefficients = coco_allocate_vector(n);
+    for (i = 0; i < n; ++i)
+      coefficients[i] = pow(sqrt(10.0), (double) (long) i / ((double) (long) n - 1.0));
+  } else if (kind == TRANSFORM_FUSED_VARS_X_HAT) {
+    transform_vars_x_hat_data_t *data;
+    data = (transform_vars_x_hat_data_t *) coco_problem_transformed_get_data(problem);
+    coefficients = coco_allocate_vector(n);
+    bbob2009_unif(coefficients, n, data->seed); /* The signs are only compared to 0.5 */
+  } else if (kind == TRANSFORM_FUSED_VARS_Z_HAT) {
+    transform_vars_z_hat_data_t *data;
+    data = (transform_vars_z_hat_data_t *) coco_problem_transformed_get_data(problem);
+    coefficients = coco_allocate_vector(n);
+    for (i = 0; i < n; ++i)
+      coefficients[i] = 2.0 * fabs(data->xopt[i]);
+  } else {
+    coefficients = NULL;
+  }
+  return coefficients;
+}
+
+/**
+ * @brief Applies the transformations of the variables to the count points in the buffer x, possibly swapping
+ * it with the buffer z, and computes the penalties. The affine transformations multiply all points at once.
+ * Marks the points whose variables are no longer finite after some operation, at which an inner level of the
+ * stack would have stopped.
+ */
+static void transform_fused_apply_vars(const transform_fused_data_t *data, const size_t n, const size_t count,
+                                       double **x, double **z, double *penalties, int *stopped) {
+  static const double alpha = 0.1;
+  double tmp, base, factor, exponent, previous, *swap;
+  size_t i, k, p;
+
+  for (k = 0; k < data->number_of_operations; ++k) {
+    const transform_fused_operation_t *operation = &data->operations[k];
+    const double *coefficients = operation->coefficients;
+
+    if (operation->kind == TRANSFORM_FUSED_VARS_AFFINE) {
+      transform_vars_affine_data_t *affine;
+      affine = (transform_vars_affine_data_t *) coco_problem_transformed_get_data(operation->problem);
+      coco_simd_affine(affine->M, affine->Mt, affine->b, *x, *z, n, n, count);
+      swap = *x;
+      *x = *z;
+      *z = swap;
+    }
+
+    for (p = 0; p < count; ++p) {
+      double *v = *x + p * n;
+
+      switch (operation->kind) {
+      case TRANSFORM_FUSED_VARS_SHIFT: {
+        const double *offset = ((transform_vars_shift_data_t *)
+            coco_problem_transformed_get_data(operation->problem))->offset;
+        for (i = 0; i < n; ++i)
+          v[i] = v[i] - offset[i];
+        break;
+      }
+      case TRANSFORM_FUSED_VARS_OSCILLATE:
+        for (i = 0; i < n; ++i) {
+          if (v[i] > 0.0) {
+            tmp = log(v[i]) / alpha;
+            base = exp(tmp + 0.49 * (sin(tmp) + sin(0.79 * tmp)));
+            v[i] = pow(base, alpha);
+          } else if (v[i] < 0.0) {
+            tmp = log(-v[i]) / alpha;
+            base = exp(tmp + 0.49 * (sin(0.55 * tmp) + sin(0.31 * tmp)));
+            v[i] = -pow(base, alpha);
+          } else {
+            v[i] = 0.0;
+          }
+        }
+        break;
+      case TRANSFORM_FUSED_VARS_ASYMMETRIC:
+        for (i = 0; i < n; ++i) {
+          if (v[i] > 0.0) {
+            exponent = 1.0 + coefficients[i] * sqrt(v[i]);
+            v[i] = pow(v[i], exponent);
+          }
+        }
+        break;
+      case TRANSFORM_FUSED_VARS_CONDITIONING:
+        for (i = 0; i < n; ++i)
+          v[i] = coefficients[i] * v[i];
+        break;
+      case TRANSFORM_FUSED_VARS_BRS:
+        for (i = 0; i < n; ++i) {
+          factor = coefficients[i];
+          if (v[i] > 0.0 && i % 2 == 0)
+            factor *= 10.0;
+          v[i] = factor * v[i];
+        }
+        break;
+      case TRANSFORM_FUSED_VARS_SCALE: {
+        const double scale = ((transform_vars_scale_data_t *)
+            coco_problem_transformed_get_data(operation->problem))->factor;
+        for (i = 0; i < n; ++i)
+          v[i] = scale * v[i];
+        break;
+      }
+      case TRANSFORM_FUSED_VARS_X_HAT:
+        for (i = 0; i < n; ++i)
+          if (coefficients[i] < 0.5)
+            v[i] = -v[i];
+        break;
+      case TRANSFORM_FUSED_VARS_Z_HAT:
+        previous = v[0];
+        for (i = 1; i < n; ++i) {
+          tmp = v[i] + 0.25 * (previous - coefficients[i - 1]);
+          previous = v[i];
+          v[i] = tmp;
+        }
+        break;
+      case TRANSFORM_FUSED_OBJ_PENALIZE: {
+        const double *lower_bounds = operation->problem->smallest_values_of_interest;
+        const double *upper_bounds = operation->problem->largest_values_of_interest;
+        double penalty = 0.0;
+        for (i = 0; i < n; ++i) {
+          const double c1 = v[i] - upper_bounds[i];
+          const double c2 = lower_bounds[i] - v[i];
+          if (c1 > 0.0) {
+            penalty += c1 * c1;
+          } else if (c2 > 0.0) {
+            penalty += c2 * c2;
+          }
+        }
+        penalties[p * data->number_of_operations + k] = penalty;
+        break;
+      }
+      default:
+        break;
+      }
+      if (operation->kind < TRANSFORM_FUSED_OBJ_SHIFT && !stopped[p] && !coco_vector_isfinite(v, n))
+        stopped[p] = 1;
+    }
+  }
+}
+
+/**
+ * @brief Evaluates the fused transformations in count points, with buffers v and z of count points, penalties
+ * for count times the number of operations and stopped for count points.
+ */
+static void transform_fused_evaluate_points(coco_problem_t *problem, const double *x, const size_t count,
+                                            double *y, double *v, double *z, double *penalties, int *stopped) {
+  static const double factor = 0.1;
+  transform_fused_data_t *data = (transform_fused_data_t *) coco_problem_transformed_get_data(problem);
+  const size_t n = problem->number_of_variables;
+  double log_y, *y_p;
+  size_t i, k, p;
+
+  for (p = 0; p < count; ++p) {
+    for (i = 0; i < n; ++i)
+      v[p * n + i] = x[p * n + i];
+    stopped[p] = !coco_vector_isfinite(x + p * n, n);
+  }
+  transform_fused_apply_vars(data, n, count, &v, &z, penalties, stopped);
+
+  for (p = 0; p < count; ++p) {
+    y_p = y + p;
+    if (stopped[p]) {
+      /* Let the stack deal with the values at which one of its levels stops */
+      coco_evaluate_function(coco_problem_transformed_get_inner_problem(problem), x + p * n, y_p);
+      continue;
+    }
+    data->innermost->evaluate_function(data->innermost, v + p * n, y_p);
+
+    for (k = data->number_of_operations; k-- > 0;) {
+      coco_problem_t *level = data->operations[k].problem;
+
+      switch (data->operations[k].kind) {
+      case TRANSFORM_FUSED_OBJ_SHIFT:
+        y_p[0] += ((transform_obj_shift_data_t *) coco_problem_transformed_get_data(level))->offset;
+        break;
+      case TRANSFORM_FUSED_OBJ_SCALE:
+        y_p[0] *= ((transform_obj_scale_data_t *) coco_problem_transformed_get_data(level))->factor;
+        break;
+      case TRANSFORM_FUSED_OBJ_POWER:
+        y_p[0] = pow(y_p[0],
+            ((transform_obj_power_data_t *) coco_problem_transformed_get_data(level))->exponent);
+        break;
+      case TRANSFORM_FUSED_OBJ_OSCILLATE:
+        if (y_p[0] != 0) {
+          log_y = log(fabs(y_p[0])) / factor;
+          if (y_p[0] > 0) {
+            y_p[0] = pow(exp(log_y + 0.49 * (sin(log_y) + sin(0.79 * log_y))), factor);
+          } else {
+            y_p[0] = -pow(exp(log_y + 0.49 * (sin(0.55 * log_y) + sin(0.31 * log_y))), factor);
+          }
+        }
+        break;
+      case TRANSFORM_FUSED_OBJ_PENALIZE:
+        y_p[0] += ((transform_obj_penalize_data_t *) coco_problem_transformed_get_data(level))->factor
+            * penalties[p * data->number_of_operations + k];
+        break;
+      default:
+        break;
+      }
+    }
+    assert(y_p[0] + 1e-13 >= problem->best_value[0]);
+  }
+}
+
+/**
+ * @brief Evaluates the fused transformations.
+ */
+static void transform_fused_evaluate(coco_problem_t *problem, const double *x, double *y) {
+  transform_fused_data_t *data = (transform_fused_data_t *) coco_problem_transformed_get_data(problem);
+  const size_t n = problem->number_of_variables;
+  double *buffer = coco_scratch_get(data->buffer, 2 * n + data->number_of_operations);
+  int stopped;
+
+  transform_fused_evaluate_points(problem, x, 1, y, buffer, buffer + n, buffer + 2 * n, &stopped);
+  coco_scratch_release(buffer, data->buffer);
+}
+
+/**
+ * @brief Evaluates the fused transformations in a batch of points, passing all of them through each operation.
+ */
+static void transform_fused_evaluate_batch(coco_problem_t *problem, const double *x, const size_t n, double *y) {
+  transform_fused_data_t *data = (transform_fused_data_t *) coco_problem_transformed_get_data(problem);
+  double *v = coco_scratch_take(n * problem->number_of_variables);
+  double *z = coco_scratch_take(n * problem->number_of_variables);
+  double *penalties = coco_scratch_take(n * data->number_of_operations);
+  int *stopped = (int *) coco_scratch_take(n); /* A double holds an int */
+
+  transform_fused_evaluate_points(problem, x, n, y, v, z, penalties, stopped);
+  coco_scratch_release(v, NULL);
+  coco_scratch_release(z, NULL);
+  coco_scratch_release(penalties, NULL);
+  coco_scratch_release((double *) stopped, NULL);
+}
+
+/**
+ * @brief Frees the data object.
+ */
+static void transform_fused_free(void *thing) {
+  transform_fused_data_t *data = (transform_fused_data_t *) thing;
+  size_t k;
+
+  for (k = 0; k < data->number_of_operations; ++k)
+    if (data->operations[k].coefficients != NULL)
+      coco_free_memory(data->operations[k].coefficients);
+  coco_free_memory(data->operations);
+  coco_free_memory(data->buffer);
+}
+
+/**
+ * @brief Creates the fused transformation of the stack of the problem.
+ *
+ * The levels are fused from the outermost one inwards, up to the first one that is not a known
+ * transformation of a single-objective unconstrained problem with the same number of variables. Returns
+ * the problem itself when there is nothing to fuse.
+ */
+static coco_problem_t *transform_fused(coco_problem_t *inner_problem) {
+  transform_fused_data_t *data;
+  coco_problem_t *problem, *level;
+  size_t k, number_of_operations = 0;
+
+  for (level = inner_problem; transform_fused_get_kind(level) != TRANSFORM_FUSED_NONE;
+      level = coco_problem_transformed_get_inner_problem(level)) {
+    if (level->number_of_objectives != 1 || level->number_of_constraints > 0
+        || level->number_of_variables != inner_problem->number_of_variables)
+      break;
+    number_of_operations++;
+  }
+  if (number_of_operations == 0)
+    return inner_problem;
+
+  data = (transform_fused_data_t *) coco_allocate_memory(sizeof(*data));
+  data->number_of_operations = number_of_operations;
+  data->operations = (transform_fused_operation_t *) coco_allocate_memory(
+      number_of_operations * sizeof(transform_fused_operation_t));
+  for (k = 0, level = inner_problem; k < number_of_operations;
+      ++k, level = coco_problem_transformed_get_inner_problem(level)) {
+    data->operations[k].kind = transform_fused_get_kind(level);
+    data->operations[k].problem = level;
+    data->operations[k].coefficients = transform_fused_coefficients(data->operations[k].kind, level);
+  }
+  data->innermost = level;
+  data->buffer = coco_allocate_vector(2 * inner_problem->number_of_variables + number_of_operations);
+
+  problem = coco_problem_transformed_allocate(inner_problem, data, transform_fused_free, "transform_fused");
+  problem->evaluate_function = transform_fused_evaluate;
+  problem->evaluate_function_batch = transform_fused_evaluate_batch;
+  coco_problem_set_name(problem, "%s", inner_problem->problem_name);
+  return problem;
+}
 #line 29 "code-experiments/src/suite_bbob.c"
 
 static coco_suite_t *coco_suite_allocate(const char *suite_name,
@@ -10924,7 +12519,8 @@ static coco_problem_t *suite_bbob_get_problem(coco_suite_t *suite,
   const size_t dimension = suite->dimensions[dimension_idx];
   const size_t instance = suite->instances[instance_idx];
 
-  problem = coco_get_bbob_problem(function, dimension, instance);
+  problem = transform_fused(coco_get_bbob_problem(function, dimension, instance));
+  (void) coco_simd_get_level(); /* settled before threads compute the problem (see coco_compute_function()) */
 
   problem->suite_dep_function = function;
   problem->suite_dep_instance = instance;
@@ -29221,7 +30817,10 @@ static coco_problem_t *coco_get_biobj_problem(const size_t function,
     } else if (function_idx == 91) {
         function1_idx = 22;
         function2_idx = 23;
-    } 
+    } else {
+        coco_error("coco_get_biobj_problem(): cannot retrieve problem f%lu", (unsigned long) function);
+        return NULL; /* never reached */
+    }
   }
       
   /* Determine the instances */
@@ -31436,7 +33035,7 @@ size_t coco_suite_get_instance_from_instance_index(const coco_suite_t *suite, co
     return 0; /* Never reached*/
   }
 
- return suite->functions[instance_idx];
+ return suite->instances[instance_idx];
 }
 
 void coco_suite_free(coco_suite_t *suite) {
@@ -32414,15 +34013,17 @@ static const double weight_constraints = 1e0;  /* factor used in logged indicato
 
 /*static const size_t bbob_nbpts_nbevals = 20; Wassim: tentative, are now observer options with these default values*/
 /*static const size_t bbob_nbpts_fval = 5;*/
-static size_t bbob_current_dim = 0;
-static size_t bbob_current_funId = 0;
-static size_t bbob_infoFile_firstInstance = 0;
-char *bbob_infoFile_firstInstance_char;
+/* The state of the open bbob logger is kept per thread, so that every thread can observe its own problem
+ * (with its own result folder). */
+static __thread size_t bbob_current_dim = 0;
+static __thread size_t bbob_current_funId = 0;
+static __thread size_t bbob_infoFile_firstInstance = 0;
+static __thread char *bbob_infoFile_firstInstance_char;
 /* a possible solution: have a list of dims that are already in the file, if the ones we're about to log
  * is != bbob_current_dim and the funId is currend_funId, create a new .info file with as suffix the
  * number of the first instance */
 static const int bbob_number_of_dimensions = 6;
-static size_t bbob_dimensions_in_current_infoFile[6] = { 0, 0, 0, 0, 0, 0 }; /* TODO should use dimensions from the suite */
+static __thread size_t bbob_dimensions_in_current_infoFile[6] = { 0, 0, 0, 0, 0, 0 }; /* TODO should use dimensions from the suite */
 
 /* The current_... mechanism fails if several problems are open.
  * For the time being this should lead to an error.
@@ -32432,7 +34033,7 @@ static size_t bbob_dimensions_in_current_infoFile[6] = { 0, 0, 0, 0, 0, 0 }; /*
  * file is generated.
  * TODO: Shouldn't the new way of handling observers already fix this?
  */
-static int bbob_logger_is_open = 0; /* this could become lock-list of .info files */
+static __thread int bbob_logger_is_open = 0; /* this could become lock-list of .info files */
 
 /* TODO: add possibility of adding a prefix to the index files (easy to do through observer options) */
 
@@ -32453,6 +34054,7 @@ typedef struct {
   double best_fvalue;
   double last_fvalue;
   short written_last_eval; /* allows writing the data of the final fun eval in the .tdat file if not already written by the t_trigger*/
+  int is_resumed; /* the data files already hold the output of the run up to the restored state, see coco_problem_restore_state() */
   double *best_solution;
   /* The following are to only pass data as a parameter in the free function. The
    * interface should probably be the same for all free functions so passing the
@@ -32642,13 +34244,17 @@ static void logger_bbob_openIndexFile(logger_bbob_data_t *logger,
                                       const char *suite_name) {
   /* to add the instance number TODO: this should be done outside to avoid redoing this for the .*dat files */
   char used_dataFile_path[COCO_PATH_MAX + 2] = { 0 };
+  size_t used_length = strlen(dataFile_path);
   int errnum, newLine = 0; /* newLine is at 1 if we need a new line in the info file */
   char *function_id_char; /* TODO: consider adding them to logger */
   char file_name[COCO_PATH_MAX + 2] = { 0 };
   char file_path[COCO_PATH_MAX + 2] = { 0 };
   FILE **target_file;
   FILE *tmp_file;
-  strncpy(used_dataFile_path, dataFile_path, COCO_PATH_MAX - strlen(used_dataFile_path) - 1);
+  /* Truncated explicitly, the buffer being zero-terminated by its initialization */
+  if (used_length > COCO_PATH_MAX - 1)
+    used_length = COCO_PATH_MAX - 1;
+  memcpy(used_dataFile_path, dataFile_path, used_length);
   if (bbob_infoFile_firstInstance == 0) {
     bbob_infoFile_firstInstance = logger->instance_id;
   }
@@ -32794,13 +34400,13 @@ static void logger_bbob_initialize(logger_bbob_data_t *logger, coco_problem_t *i
   COCO_PATH_MAX - strlen(dataFile_path) - 1);
 
   logger_bbob_open_dataFile(&(logger->fdata_file), logger->observer->result_folder, dataFile_path, ".dat");
-  fprintf(logger->fdata_file, bbob_file_header_str, logger->optimal_fvalue);
-
   logger_bbob_open_dataFile(&(logger->tdata_file), logger->observer->result_folder, dataFile_path, ".tdat");
-  fprintf(logger->tdata_file, bbob_file_header_str, logger->optimal_fvalue);
-
   logger_bbob_open_dataFile(&(logger->rdata_file), logger->observer->result_folder, dataFile_path, ".rdat");
-  fprintf(logger->rdata_file, bbob_file_header_str, logger->optimal_fvalue);
+  if (!logger->is_resumed) {
+    fprintf(logger->fdata_file, bbob_file_header_str, logger->optimal_fvalue);
+    fprintf(logger->tdata_file, bbob_file_header_str, logger->optimal_fvalue);
+    fprintf(logger->rdata_file, bbob_file_header_str, logger->optimal_fvalue);
+  }
   logger->is_initialized = 1;
   coco_free_memory(tmpc_dim);
   coco_free_memory(tmpc_funId);
@@ -33034,6 +34640,7 @@ static coco_problem_t *logger_bbob(coco_observer_t *observer, coco_problem_t *in
   logger_data->function_id = coco_problem_get_suite_dep_function(inner_problem);
   logger_data->instance_id = coco_problem_get_suite_dep_instance(inner_problem);
   logger_data->written_last_eval = 0;
+  logger_data->is_resumed = 0;
   logger_data->last_fvalue = DBL_MAX;
   logger_data->is_initialized = 0;
   logger_data->log_discrete_as_int = observer->log_discrete_as_int;
@@ -35671,6 +37278,151 @@ static coco_problem_t *logger_rw(coco_observer_t *observer, coco_problem_t *inne
   return problem;
 }
 #line 360 "code-experiments/src/coco_observer.c"
+#line 1 "code-experiments/src/logger_hits.c"
+/**
+ * @file logger_hits.c
+ * @brief Implementation of the hits logger.
+ *
+ * Records in memory the evaluation at which each target of the standard ladder (10**2 down to 10**-8, five
+ * targets per decade, relative to the optimal value) is first hit. Only improvements of the best value are
+ * checked against the next target, so the logger adds a comparison and a counter to each evaluation. When the
+ * problem is freed, one line is appended to the file hits.txt of the result folder: the problem ID, the number
+ * of evaluations, the best value minus the optimal value, and the first hits of the targets that were hit.
+ */
+
+#include <stdio.h>
+#include <assert.h>
+#include <math.h>
+
+#line 17 "code-experiments/src/logger_hits.c"
+#line 18 "code-experiments/src/logger_hits.c"
+
+/**
+ * @brief The number of targets of the standard ladder, from 10**2 down to 10**-8.
+ */
+#define LOGGER_HITS_NUMBER_OF_TARGETS 51
+
+/**
+ * @brief The hits logger data type.
+ */
+typedef struct {
+  char *file_name;                      /**< @brief The summary file, opened once when the problem is freed. */
+  char *problem_id;                     /**< @brief The ID of the observed problem. */
+  int precision_f;                      /**< @brief Precision for outputting the best value. */
+  double optimal_value;                 /**< @brief The value the targets are relative to. */
+  double best_value;                    /**< @brief The best value observed so far. */
+  double next_target;                   /**< @brief The next target, relative to the optimal value. */
+  size_t number_of_hits;                /**< @brief The number of targets hit so far. */
+  size_t number_of_evaluations;         /**< @brief The number of evaluations performed so far. */
+  size_t hits[LOGGER_HITS_NUMBER_OF_TARGETS]; /**< @brief The evaluation of the first hit of each target. */
+} logger_hits_data_t;
+
+/**
+ * @brief Returns the k-th target of the standard ladder, relative to the optimal value.
+ */
+static double logger_hits_target(const size_t k) {
+  return pow(10.0, 2.0 - (double) k / 5.0);
+}
+
+/**
+ * @brief Appends the summary of the problem to the summary file and frees the memory of the given hits logger.
+ */
+static void logger_hits_free(void *stuff) {
+
+  logger_hits_data_t *logger;
+  FILE *summary_file;
+  size_t i;
+
+  assert(stuff != NULL);
+  logger = (logger_hits_data_t *) stuff;
+
+  summary_file = fopen(logger->file_name, "a");
+  if (summary_file == NULL) {
+    coco_error("logger_hits_free(): failed to open file %s.", logger->file_name);
+    return; /* Never reached */
+  }
+  fseek(summary_file, 0, SEEK_END);
+  if (ftell(summary_file) == 0)
+    fprintf(summary_file, "%% problem_id | evaluations | best value - optimal value | first hits of the targets "
+        "10**2 ... 10**-8, five per decade, up to the first target missed\n");
+  fprintf(summary_file, "%s %lu %.*e", logger->problem_id, (unsigned long) logger->number_of_evaluations,
+      logger->precision_f, logger->best_value - logger->optimal_value);
+  for (i = 0; i < logger->number_of_hits; i++)
+    fprintf(summary_file, " %lu", (unsigned long) logger->hits[i]);
+  fprintf(summary_file, "\n");
+  fclose(summary_file);
+
+  coco_free_memory(logger->file_name);
+  coco_free_memory(logger->problem_id);
+}
+
+/**
+ * @brief Evaluates the function, increases the number of evaluations and records the targets that have been
+ * hit.
+ */
+static void logger_hits_evaluate(coco_problem_t *problem, const double *x, double *y) {
+
+  logger_hits_data_t *logger = (logger_hits_data_t *) coco_problem_transformed_get_data(problem);
+
+  coco_evaluate_function(coco_problem_transformed_get_inner_problem(problem), x, y);
+  logger->number_of_evaluations++;
+
+  if (y[0] < logger->best_value) {
+    logger->best_value = y[0];
+    while (logger->number_of_hits < LOGGER_HITS_NUMBER_OF_TARGETS
+        && y[0] - logger->optimal_value <= logger->next_target) {
+      logger->hits[logger->number_of_hits++] = logger->number_of_evaluations;
+      logger->next_target = logger_hits_target(logger->number_of_hits);
+    }
+  }
+}
+
+/**
+ * @brief Initializes the hits logger.
+ */
+static coco_problem_t *logger_hits(coco_observer_t *observer, coco_problem_t *inner_problem) {
+
+  logger_hits_data_t *logger_data;
+  coco_problem_t *problem;
+
+  if (inner_problem->number_of_objectives != 1) {
+    coco_warning("logger_hits(): The hits logger shouldn't be used to log a problem with %d objectives",
+        inner_problem->number_of_objectives);
+  }
+
+  /* Initialize the logger_hits_data_t object instance */
+  logger_data = (logger_hits_data_t *) coco_allocate_memory(sizeof(*logger_data));
+  logger_data->file_name = coco_allocate_string(COCO_PATH_MAX + 1);
+  memcpy(logger_data->file_name, observer->result_folder, strlen(observer->result_folder) + 1);
+  coco_join_path(logger_data->file_name, COCO_PATH_MAX, "hits.txt", NULL);
+  logger_data->problem_id = coco_strdup(coco_problem_get_id(inner_problem));
+  logger_data->precision_f = observer->precision_f;
+  logger_data->optimal_value = inner_problem->best_value[0];
+  logger_data->best_value = HUGE_VAL;
+  logger_data->next_target = logger_hits_target(0);
+  logger_data->number_of_hits = 0;
+  logger_data->number_of_evaluations = 0;
+
+  problem = coco_problem_transformed_allocate(inner_problem, logger_data, logger_hits_free, observer->observer_name);
+  problem->evaluate_function = logger_hits_evaluate;
+  return problem;
+}
+
+/**
+ * @brief Initializes the hits observer, whose loggers append their summaries to the file hits.txt of the
+ * result folder.
+ */
+static void observer_hits(coco_observer_t *observer, const char *options, coco_option_keys_t **option_keys) {
+
+  (void) options; /* The hits observer has no options of its own */
+  *option_keys = NULL;
+
+  observer->logger_allocate_function = logger_hits;
+  observer->logger_free_function = logger_hits_free;
+  observer->data_free_function = NULL;
+  observer->data = NULL;
+}
+#line 361 "code-experiments/src/coco_observer.c"
 
 /**
  * Currently, three observers are supported:
@@ -35679,9 +37431,11 @@ static coco_problem_t *logger_rw(coco_observer_t *observer, coco_problem_t *inne
  * - "bbob-biobj" is the observer for bi-objective problems, which creates *.info, *.dat and *.tdat files for
  * the given indicators, as well as an archive folder with *.adat files containing nondominated solutions.
  * - "toy" is a simple observer that logs when a target has been hit.
+ * - "hits" records the first hits of the standard targets in memory and writes one line per problem, for runs
+ * that only need these (see logger_hits.c).
  *
  * @param observer_name A string containing the name of the observer. Currently supported observer names are
- * "bbob", "bbob-biobj", "toy". Strings "no_observer", "" or NULL return NULL.
+ * "bbob", "bbob-biobj", "toy", "hits". Strings "no_observer", "" or NULL return NULL.
  * @param observer_options A string of pairs "key: value" used to pass the options to the observer. Some
  * observer options are general, while others are specific to some observers. Here we list only the general
  * options, see observer_bbob, observer_biobj and observer_toy for options of the specific observers.
@@ -35846,6 +37600,8 @@ coco_observer_t *coco_observer(const char *observer_name, const char *observer_o
     observer_biobj(observer, observer_options, &additional_option_keys);
   } else if (0 == strcmp(observer_name, "rw")) {
     observer_rw(observer, observer_options, &additional_option_keys);
+  } else if (0 == strcmp(observer_name, "hits")) {
+    observer_hits(observer, observer_options, &additional_option_keys);
   } else {
     coco_warning("Unknown observer!");
     return NULL;
@@ -35901,7 +37657,9 @@ coco_problem_t *coco_problem_add_observer(coco_problem_t *problem, coco_observer
   }
 
   assert(observer->logger_allocate_function);
-  return observer->logger_allocate_function(observer, problem);
+  problem = observer->logger_allocate_function(observer, problem);
+  problem->is_logger = 1;
+  return problem;
 }
 
 /**
@@ -35963,6 +37721,134 @@ const char *coco_observer_get_result_folder(const coco_observer_t *observer) {
   return observer->result_folder;
 }
 
+/**
+ * @brief The number of values in the state of a problem layer, see coco_problem_save_state().
+ */
+static size_t coco_problem_layer_state_size(const coco_problem_t *problem) {
+  size_t size = 3;
+  if (problem->is_logger && problem->evaluate_function == logger_bbob_evaluate)
+    size += 5 + problem->number_of_variables;
+  else if (problem->is_logger && problem->evaluate_function == logger_hits_evaluate)
+    size += 3 + LOGGER_HITS_NUMBER_OF_TARGETS;
+  return size;
+}
+
+/**
+ * Saves the evaluation state of an observed problem: the evaluation counters and best observed values of the
+ * problem and of the problems it wraps, and the state of the bbob and hits loggers among them. The files of the
+ * loggers are flushed, so that their output up to this state is on disk. The state of other loggers is not
+ * saved. Evaluation numbers are stored as doubles, exactly up to 2**53.
+ *
+ * @param problem The observed COCO problem.
+ * @param state The values of the state (the first one is their number), or NULL to only count them.
+ *
+ * @return The number of values in the state.
+ */
+size_t coco_problem_save_state(const coco_problem_t *problem, double *state) {
+  size_t size = 1, i;
+  logger_bbob_data_t *bbob;
+  logger_hits_data_t *hits;
+
+  while (1) {
+    if (state != NULL) {
+      double *values = state + size;
+      values[0] = (double) problem->evaluations;
+      values[1] = problem->best_observed_fvalue[0];
+      values[2] = (double) problem->best_observed_evaluation[0];
+      if (problem->is_logger && problem->evaluate_function == logger_bbob_evaluate) {
+        bbob = (logger_bbob_data_t *) coco_problem_transformed_get_data(problem);
+        values[3] = (double) bbob->number_of_evaluations;
+        values[4] = (double) bbob->number_of_evaluations_constraints;
+        values[5] = bbob->best_fvalue;
+        values[6] = bbob->last_fvalue;
+        values[7] = bbob->written_last_eval;
+        for (i = 0; i < problem->number_of_variables; i++)
+          values[8 + i] = bbob->best_solution[i];
+        if (bbob->index_file != NULL)
+          fflush(bbob->index_file);
+        if (bbob->fdata_file != NULL)
+          fflush(bbob->fdata_file);
+        if (bbob->tdata_file != NULL)
+          fflush(bbob->tdata_file);
+        if (bbob->rdata_file != NULL)
+          fflush(bbob->rdata_file);
+      } else if (problem->is_logger && problem->evaluate_function == logger_hits_evaluate) {
+        hits = (logger_hits_data_t *) coco_problem_transformed_get_data(problem);
+        values[3] = (double) hits->number_of_evaluations;
+        values[4] = hits->best_value;
+        values[5] = (double) hits->number_of_hits;
+        for (i = 0; i < LOGGER_HITS_NUMBER_OF_TARGETS; i++)
+          values[6 + i] = (double) hits->hits[i];
+      }
+    }
+    size += coco_problem_layer_state_size(problem);
+    if (!problem->is_logger)
+      break;
+    problem = coco_problem_transformed_get_inner_problem(problem);
+  }
+
+  if (state != NULL)
+    state[0] = (double) size;
+  return size;
+}
+
+/**
+ * Restores the evaluation state saved by coco_problem_save_state() into a problem that has not been evaluated
+ * yet, observed the same way. Evaluations then continue from the saved state: the bbob logger does not write
+ * the headers of its data files again, and its triggers are set as if it had observed all the evaluations, so
+ * that data files holding the output up to the saved state are continued as by an uninterrupted run.
+ *
+ * @param problem The observed COCO problem.
+ * @param state The values saved by coco_problem_save_state().
+ */
+void coco_problem_restore_state(coco_problem_t *problem, const double *state) {
+  size_t size = 1, i;
+  logger_bbob_data_t *bbob;
+  logger_hits_data_t *hits;
+
+  if (coco_problem_save_state(problem, NULL) != (size_t) state[0]) {
+    coco_error("coco_problem_restore_state(): the state does not match problem %s", problem->problem_id);
+    return; /* Never reached */
+  }
+
+  while (1) {
+    const double *values = state + size;
+    problem->evaluations = (size_t) values[0];
+    problem->best_observed_fvalue[0] = values[1];
+    problem->best_observed_evaluation[0] = (size_t) values[2];
+    if (problem->is_logger && problem->evaluate_function == logger_bbob_evaluate) {
+      bbob = (logger_bbob_data_t *) coco_problem_transformed_get_data(problem);
+      bbob->number_of_evaluations = (size_t) values[3];
+      bbob->number_of_evaluations_constraints = (size_t) values[4];
+      bbob->best_fvalue = values[5];
+      bbob->last_fvalue = values[6];
+      bbob->written_last_eval = (short) values[7];
+      for (i = 0; i < problem->number_of_variables; i++)
+        bbob->best_solution[i] = values[8 + i];
+      bbob->is_resumed = bbob->number_of_evaluations > 0;
+      /* The target trigger only follows the improvements after the first evaluation */
+      if (problem->best_observed_evaluation[0] > 1)
+        coco_observer_targets_trigger(bbob->targets, bbob->best_fvalue - bbob->optimal_fvalue);
+      while (coco_observer_evaluations_trigger_first(bbob->evaluations,
+          bbob->number_of_evaluations + bbob->number_of_evaluations_constraints));
+      while (coco_observer_evaluations_trigger_second(bbob->evaluations,
+          bbob->number_of_evaluations + bbob->number_of_evaluations_constraints));
+    } else if (problem->is_logger && problem->evaluate_function == logger_hits_evaluate) {
+      hits = (logger_hits_data_t *) coco_problem_transformed_get_data(problem);
+      hits->number_of_evaluations = (size_t) values[3];
+      hits->best_value = values[4];
+      hits->number_of_hits = (size_t) values[5];
+      for (i = 0; i < LOGGER_HITS_NUMBER_OF_TARGETS; i++)
+        hits->hits[i] = (size_t) values[6 + i];
+      hits->next_target = logger_hits_target(hits->number_of_hits);
+    }
+    size += coco_problem_layer_state_size(problem);
+    if (!problem->is_logger)
+      break;
+    problem = coco_problem_transformed_get_inner_problem(problem);
+  }
+}
+
 #line 1 "code-experiments/src/coco_archive.c"
 /**
  * @file coco_archive.c
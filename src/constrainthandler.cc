@@ -1,6 +1,6 @@
 #include "constrainthandler.h"
 #include "util.h"
-#include "solution.h"
+#include "checkpoint.h"
 #include <stdexcept>
 
 std::function<ConstraintHandler* (ArrayXd const, ArrayXd const)> 
@@ -22,15 +22,15 @@ ConstraintHandler::create(std::string const id){
 	throw std::invalid_argument("no such ConstraintHandler: " + id);
 }
 
-bool ConstraintHandler::isFeasible(Solution const * const p) const{
+bool ConstraintHandler::isFeasible(ConstColumn const& x) const{
 	for (int i = 0; i < D; i++){
-		if (p->X(i) < lb(i) || p->X(i) > ub(i) )
+		if (x(i) < lb(i) || x(i) > ub(i) )
 			return false;
 	}
 	return true;
 }
 
-bool ConstraintHandler::resample(Solution * const /*p*/, int const /*resamples*/){
+bool ConstraintHandler::resample(Column /*x*/, int const /*resamples*/){
 	return false;
 }
 
@@ -38,108 +38,112 @@ int ConstraintHandler::getCorrections() const {
 	return nCorrected;
 }
 
+void ConstraintHandler::save(Checkpoint& checkpoint) const {
+	checkpoint.write(nCorrected);
+}
+
+void ConstraintHandler::restore(Checkpoint& checkpoint){
+	checkpoint.read(nCorrected);
+}
+
 // Differential Evolution
-void RandBaseRepair::repair(Solution* const p, Solution const* const base, Solution const* const /*target*/) {
+void RandBaseRepair::repair(Column x, ConstColumn const& base, ConstColumn const& /*target*/) {
 	bool repaired = false;
 	for (int i = 0; i < D; i++){
-		if (p->X(i) > ub(i)){
-			p->setX(i, base->X(i) + rng.randDouble(0,1) * (ub(i) - base->X(i)));
+		if (x(i) > ub(i)){
+			x(i) = base(i) + rng.randDouble(0,1) * (ub(i) - base(i));
 			repaired=true;
-		} else if (p->X(i) < lb(i)){
-			p->setX(i, base->X(i) + rng.randDouble(0,1) * (lb(i) - base->X(i)));
+		} else if (x(i) < lb(i)){
+			x(i) = base(i) + rng.randDouble(0,1) * (lb(i) - base(i));
 			repaired=true;
 		}
 	}
 	if (repaired) nCorrected++;
 }
 
-void MidpointBaseRepair::repair(Solution* const p, Solution const* const base, Solution const* const /*target*/) {
+void MidpointBaseRepair::repair(Column x, ConstColumn const& base, ConstColumn const& /*target*/) {
 	bool repaired = false;
 	for (int i = 0; i < D; i++){
-		if (p->X(i) > ub(i)){
-			p->setX(i, 0.5 * (base->X(i) + ub(i)));
+		if (x(i) > ub(i)){
+			x(i) = 0.5 * (base(i) + ub(i));
 			repaired=true;
-		} else if (p->X(i) < lb(i)){
-			p->setX(i, 0.5 * (base->X(i) + lb(i)));
+		} else if (x(i) < lb(i)){
+			x(i) = 0.5 * (base(i) + lb(i));
 			repaired=true;
 		}
 	}
 	if (repaired) nCorrected++;
 }
 
-void MidpointTargetRepair::repair(Solution* const p, Solution const* const /*base*/, Solution const* const target) {
+void MidpointTargetRepair::repair(Column x, ConstColumn const& /*base*/, ConstColumn const& target) {
 	bool repaired = false;
 	for (int i = 0; i < D; i++){
-		if (p->X(i) > ub(i)){
-			p->setX(i, 0.5 * (target->X(i) + ub(i)));
+		if (x(i) > ub(i)){
+			x(i) = 0.5 * (target(i) + ub(i));
 			repaired=true;
-		} else if (p->X(i) < lb(i)){
-			p->setX(i, 0.5 * (target->X(i) + lb(i)));
+		} else if (x(i) < lb(i)){
+			x(i) = 0.5 * (target(i) + lb(i));
 			repaired=true;
 		}
 	}
 	if (repaired) nCorrected++;
 }
 
-void ProjectionMidpointRepair::repair(Solution* const p, Solution const* const /*base*/, Solution const* const /*target*/) {
-	ArrayXd const x = p->X();
-	std::vector<double>alphas(D+1);
-	alphas[D] = 1.;
+void ProjectionMidpointRepair::repair(Column x, ConstColumn const& /*base*/, ConstColumn const& /*target*/) {
+	double alpha = std::numeric_limits<double>::max(); // Smallest scaling factor over all dimensions
 
 	for (int i = 0; i < D; i++){
-		if (x(i) > ub(i)){
-			alphas[i] = (lb(i) - ub(i))/(lb(i) - 2. * x(i) + ub(i));
-		} else if (x(i) < lb(i)){
-			alphas[i] = (ub(i) - lb(i))/(lb(i) - 2. * x(i) + ub(i));
-		} else
-			alphas[i] = std::numeric_limits<double>::max(); 
+		double alpha_i = std::numeric_limits<double>::max();
+		if (x(i) > ub(i))
+			alpha_i = (lb(i) - ub(i))/(lb(i) - 2. * x(i) + ub(i));
+		else if (x(i) < lb(i))
+			alpha_i = (ub(i) - lb(i))/(lb(i) - 2. * x(i) + ub(i));
+		if (i == 0 || alpha_i < alpha)
+			alpha = alpha_i;
 	}
 
-	auto alpha=std::min_element(alphas.begin(), alphas.end());
-	if (alpha != std::next(alphas.end(), -1)){
-		p->setX((1. - *alpha) * (lb + ub) / 2. + *alpha * x);
+	if (!(1. < alpha)){
+		x = (1. - alpha) * (lb + ub) / 2. + alpha * x;
 		nCorrected++;
 	}
 
-	p->setX(p->X().max(lb).min(ub)); // clamp
+	x = x.max(lb).min(ub); // clamp
 }
 
-void ProjectionBaseRepair::repair(Solution* const p, Solution const* const base, Solution const* const /*target*/) {
-	ArrayXd const x = p->X();
-	std::vector<double> alphas(D+1);
-	alphas[D] = 1.;
+void ProjectionBaseRepair::repair(Column x, ConstColumn const& base, ConstColumn const& /*target*/) {
+	double alpha = std::numeric_limits<double>::max(); // Smallest scaling factor over all dimensions
 
 	for (int i = 0; i < D; i++){
-		if (x(i) > ub(i) && x(i) - base->X(i) > 1.0e-12){
-			alphas[i] = (ub(i) - base->X(i)) / (x(i) - base->X(i));
-		} else if (x(i) < lb(i) && base->X(i) - x(i) > 1.0e-12){
-			alphas[i] = (base->X(i) - lb(i)) / (base->X(i) - x(i));
-		} else
-			alphas[i] = std::numeric_limits<double>::max(); 
+		double alpha_i = std::numeric_limits<double>::max();
+		if (x(i) > ub(i) && x(i) - base(i) > 1.0e-12)
+			alpha_i = (ub(i) - base(i)) / (x(i) - base(i));
+		else if (x(i) < lb(i) && base(i) - x(i) > 1.0e-12)
+			alpha_i = (base(i) - lb(i)) / (base(i) - x(i));
+		if (i == 0 || alpha_i < alpha)
+			alpha = alpha_i;
 	}
 
-	auto alpha=std::min_element(alphas.begin(), alphas.end());
-	if (alpha != std::next(alphas.end(), -1)){
-		p->setX((1.- *alpha) * base->X() + *alpha * x);
+	if (!(1. < alpha)){
+		x = (1.- alpha) * base + alpha * x;
 		nCorrected++;
 	}
 
-	p->setX(p->X().max(lb).min(ub)); // clamp
+	x = x.max(lb).min(ub); // clamp
 }
 
-void ConservatismRepair::repair(Solution* const p, Solution const*const base, Solution const*const /*target*/){
-	if (!isFeasible(p)){
-		p->copy(base);
+void ConservatismRepair::repair(Column x, ConstColumn const& base, ConstColumn const& /*target*/){
+	if (!isFeasible(x)){
+		x = base;
 		nCorrected++;
 	}
 }
 
 // Generic
-bool ResamplingRepair::resample(Solution * const p, int const resamples) {
-	if (isFeasible(p)){
+bool ResamplingRepair::resample(Column x, int const resamples) {
+	if (isFeasible(x)){
 		return false;
 	} else if (resamples >= maxResamples){
-		p->setX(p->X().max(lb).min(ub)); // clamp
+			x = x.max(lb).min(ub); // clamp
 		return false;
 	}
 
@@ -149,19 +153,19 @@ bool ResamplingRepair::resample(Solution * const p, int const resamples) {
 	return true;
 }
 
-void DeathPenalty::penalize(Solution* const p) {
-	if (!isFeasible(p)){
-		p->setFitness(std::numeric_limits<double>::max());
+void DeathPenalty::penalize(Population& population, int const i) {
+	if (!isFeasible(population.X(i))){
+		population.setFitness(i, std::numeric_limits<double>::max());
 		nCorrected++;
 	}
 }
 
 // Reinitialization
-void ReinitializationRepair::repair(Solution* const p) {
+void ReinitializationRepair::repair(Column x) {
 	bool repaired = false;
 	for (int i = 0; i < D; i++){
-		if (p->X(i) < lb(i) || p->X(i) > ub(i)){
-			p->setX(i, rng.randDouble(lb(i), ub(i)));
+		if (x(i) < lb(i) || x(i) > ub(i)){
+			x(i) = rng.randDouble(lb(i), ub(i));
 			repaired=true;
 		}
 	}
@@ -169,14 +173,14 @@ void ReinitializationRepair::repair(Solution* const p) {
 }
 
 // Projection
-void ProjectionRepair::repair(Solution* const p) {
+void ProjectionRepair::repair(Column x) {
 	bool repaired = false;
 	for (int i = 0; i < D; i++){
-		if (p->X(i) < lb(i)){
-			p->setX(i, lb(i));
+		if (x(i) < lb(i)){
+			x(i) = lb(i);
 			repaired=true;
-		} else if (p->X(i) > ub(i)){
-			p->setX(i, ub(i));
+		} else if (x(i) > ub(i)){
+			x(i) = ub(i);
 			repaired=true;
 		}
 	}
@@ -185,16 +189,16 @@ void ProjectionRepair::repair(Solution* const p) {
 }
 
 // Reflection
-void ReflectionRepair::repair(Solution* const p) {
+void ReflectionRepair::repair(Column x) {
 	bool repaired = false;
 	for (int i = 0; i < D; i++){
 		while (true){
-			if (p->X(i) < lb(i)){
-				p->setX(i, 2. * lb(i) - p->X(i));
+			if (x(i) < lb(i)){
+				x(i) = 2. * lb(i) - x(i);
 				repaired=true;
 			}
-			else if (p->X(i) > ub(i)){
-				p->setX(i, 2. * ub(i) - p->X(i));
+			else if (x(i) > ub(i)){
+				x(i) = 2. * ub(i) - x(i);
 				repaired=true;
 			} else
 				break;
@@ -204,14 +208,14 @@ void ReflectionRepair::repair(Solution* const p) {
 }
 
 // Wrapping
-void WrappingRepair::repair(Solution* const p) {
+void WrappingRepair::repair(Column x) {
 	bool repaired = false;
 	for (int i = 0; i < D; i++){
-		if (p->X(i) < lb(i)){
-			p->setX(i, ub(i) - std::fmod(lb(i) - p->X(i), std::abs(ub(i)-lb(i))));
+		if (x(i) < lb(i)){
+			x(i) = ub(i) - std::fmod(lb(i) - x(i), std::abs(ub(i)-lb(i)));
 			repaired=true;
-		} else if (p->X(i) > ub(i)) {
-			p->setX(i, lb(i) + std::fmod(p->X(i) - ub(i), std::abs(ub(i)-lb(i))));
+		} else if (x(i) > ub(i)) {
+			x(i) = lb(i) + std::fmod(x(i) - ub(i), std::abs(ub(i)-lb(i)));
 			repaired=true;
 		}
 	}
@@ -230,40 +234,39 @@ TransformationRepair::TransformationRepair(ArrayXd const lb, ArrayXd const ub)
 	}
 }
 
-void TransformationRepair::repair(Solution* const p) {
-	bool repaired = shift(p);
+void TransformationRepair::repair(Column x) {
+	bool repaired = shift(x);
 	for (int i = 0; i < D; i++){
-		double const x_i = p->X(i);
-		if (x_i < lb(i) + al(i)){
-			p->setX(i, lb(i) + pow(x_i - (lb(i) - al(i)),2.)/(4.*al(i)));
+		if (x(i) < lb(i) + al(i)){
+			x(i) = lb(i) + pow(x(i) - (lb(i) - al(i)),2.)/(4.*al(i));
 			repaired=true;
 		}
-		else if (x_i > ub(i)-au(i)){
-			p->setX(i, ub(i) - pow(x_i - (ub(i) + au(i)),2.)/(4.*au(i)));
+		else if (x(i) > ub(i)-au(i)){
+			x(i) = ub(i) - pow(x(i) - (ub(i) + au(i)),2.)/(4.*au(i));
 			repaired=true;
 		}
 	}
 	if (repaired) nCorrected++;
 }
 
-bool TransformationRepair::shift(Solution* const p){
+bool TransformationRepair::shift(Column x){
 	bool repaired = false;
 	for (int i = 0; i < D; i++){
-		if (p->X(i) < xlo(i)) {
-			p->setX(i, p->X(i) + r(i) * (1 + (int)((xlo(i) - p->X(i))/r(i))));
+		if (x(i) < xlo(i)) {
+			x(i) = x(i) + r(i) * (1 + (int)((xlo(i) - x(i))/r(i)));
 			repaired=true;
 		}
-		if (p->X(i) > xhi(i)){
-			p->setX(i, p->X(i) - r(i) * (1 + (int)((p->X(i) - xhi(i))/r(i))));
+		if (x(i) > xhi(i)){
+			x(i) = x(i) - r(i) * (1 + (int)((x(i) - xhi(i))/r(i)));
 			repaired=true;
 		}
 
-		if (p->X(i) < lb(i) - al(i)){
-			p->setX(i, p->X(i) + 2. * (lb(i) - al(i) - p->X(i)));
+		if (x(i) < lb(i) - al(i)){
+			x(i) = x(i) + 2. * (lb(i) - al(i) - x(i));
 			repaired=true;
 		}
-		if (p->X(i) > ub(i) + au(i)){
-			p->setX(i, p->X(i) - 2. * (p->X(i) - ub(i) - au(i)));
+		if (x(i) > ub(i) + au(i)){
+			x(i) = x(i) - 2. * (x(i) - ub(i) - au(i));
 			repaired=true;
 		}
 	}
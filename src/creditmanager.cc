@@ -16,57 +16,51 @@ std::function<CreditManager* ()> CreditManager::create(std::string const id){
 	throw std::invalid_argument("no such CreditManager: " + id);
 }
 
-ArrayXd DiversityRatio::getCredit(ArrayXd const& fitnessDeltas, ArrayXd const& previousDistances, 
-	ArrayXd const& currentDistances) const {
-	return fitnessDeltas.unaryExpr([](double const& x){
+void DiversityRatio::getCredit(ArrayXd const& fitnessDeltas, ArrayXd const& previousDistances, 
+	ArrayXd const& currentDistances, ArrayXd& credit) const {
+	credit = fitnessDeltas.unaryExpr([](double const& x){
 		return x > 0. ? 1. : 0.;
 	}) * (currentDistances / previousDistances);
 }
 
-ArrayXd SquaredDiversityRatio::getCredit(ArrayXd const& fitnessDeltas, ArrayXd const& previousDistances, 
-	ArrayXd const& currentDistances) const {
-	return fitnessDeltas.unaryExpr([](double const& x){
+void SquaredDiversityRatio::getCredit(ArrayXd const& fitnessDeltas, ArrayXd const& previousDistances, 
+	ArrayXd const& currentDistances, ArrayXd& credit) const {
+	credit = fitnessDeltas.unaryExpr([](double const& x){
 		return x > 0. ? 1. : 0.;
 	}) * (currentDistances / previousDistances).pow(2);
 }
 
-ArrayXd FitnessScaledByDiversityRatio::getCredit(ArrayXd const& fitnessDeltas, ArrayXd const& previousDistances, 
-	ArrayXd const& currentDistances) const {
-	return fitnessDeltas.max(0) * (currentDistances / previousDistances);
+void FitnessScaledByDiversityRatio::getCredit(ArrayXd const& fitnessDeltas, ArrayXd const& previousDistances, 
+	ArrayXd const& currentDistances, ArrayXd& credit) const {
+	credit = fitnessDeltas.max(0) * (currentDistances / previousDistances);
 }
 
-ArrayXd FitnessScaledBySquaredDiversityRatio::getCredit(ArrayXd const& fitnessDeltas, 
-		ArrayXd const& previousDistances, ArrayXd const& currentDistances) const {
-	return fitnessDeltas.max(0) * (currentDistances / previousDistances).pow(2);
+void FitnessScaledBySquaredDiversityRatio::getCredit(ArrayXd const& fitnessDeltas, 
+		ArrayXd const& previousDistances, ArrayXd const& currentDistances, ArrayXd& credit) const {
+	credit = fitnessDeltas.max(0) * (currentDistances / previousDistances).pow(2);
 }
 
-ArrayXd FitnessImprovement::getCredit(ArrayXd const& fitnessDeltas, ArrayXd const& /*previousDistances*/, 
-	ArrayXd const& /*currentDistances*/) const {
-	return fitnessDeltas.max(0);
+void FitnessImprovement::getCredit(ArrayXd const& fitnessDeltas, ArrayXd const& /*previousDistances*/, 
+	ArrayXd const& /*currentDistances*/, ArrayXd& credit) const {
+	credit = fitnessDeltas.max(0);
 }
 
-ArrayXd Compass::getCredit(ArrayXd const& fitnessDeltas, ArrayXd const& previousDistances, 
-	ArrayXd const& currentDistances) const {
-	ArrayXd const diversityDeltas = currentDistances - previousDistances;
-
-	MatrixXd vectors(2, fitnessDeltas.size());
-	vectors.row(0) = diversityDeltas / diversityDeltas.abs().maxCoeff();
-	vectors.row(1) = fitnessDeltas / fitnessDeltas.abs().maxCoeff();
-
-	ArrayXd angles = ArrayXd::NullaryExpr(vectors.cols(), 
-			[this,&vectors](Eigen::Index const i){
-				return c.dot(vectors.col(i)); 
-			}
-	);
-	return angles - angles.minCoeff();
+void Compass::getCredit(ArrayXd const& fitnessDeltas, ArrayXd const& previousDistances, 
+	ArrayXd const& currentDistances, ArrayXd& credit) const {
+	// The (diversity, fitness) change of each trial, each scaled by its largest magnitude, projected on c
+	double const diversityScale = (currentDistances - previousDistances).abs().maxCoeff();
+	double const fitnessScale = fitnessDeltas.abs().maxCoeff();
+	credit = c(0) * ((currentDistances - previousDistances) / diversityScale) + c(1) * (fitnessDeltas / fitnessScale);
+	credit -= credit.minCoeff();
 }
 
-ArrayXd ParetoDominance::getCredit(ArrayXd const& fitnessDeltas, ArrayXd const& previousDistances, 
-	ArrayXd const& currentDistances) const{
+void ParetoDominance::getCredit(ArrayXd const& fitnessDeltas, ArrayXd const& previousDistances, 
+	ArrayXd const& currentDistances, ArrayXd& credit) const {
 
 	int const popSize = fitnessDeltas.size();
-	ArrayXd dominates = ArrayXd::Zero(popSize);
-	ArrayXd const diversityDeltas = currentDistances - previousDistances;
+	ArrayXd& dominates = credit;
+	dominates.setZero(popSize);
+	auto const diversityDeltas = currentDistances - previousDistances; // Evaluated per coefficient
 
 #define DOMINATES(X,Y) \
 	(fitnessDeltas(X) > fitnessDeltas(Y) && diversityDeltas(X) >= diversityDeltas(Y)) || \
@@ -80,6 +74,4 @@ ArrayXd ParetoDominance::getCredit(ArrayXd const& fitnessDeltas, ArrayXd const&
 				dominates(j)++;
 		}
 	}
-
-	return dominates;
 }
@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <cmath>
 #include "util.h"
 #include "crossovermanager.h"
 
@@ -9,37 +11,64 @@ std::function<CrossoverManager* ()> CrossoverManager::create(std::string const i
 	throw std::invalid_argument("no such CrossoverManager: " + id);
 }
 
-Solution* BinomialCrossoverManager::crossover(Solution const* const target, Solution const* const donor, double const Cr) const{
-	ArrayXd x = target->X();
-	unsigned int const jrand = rng.randInt(0,x.size()-1);
-	for (unsigned int j = 0; j < x.size(); j++){
-		if (j == jrand || rng.randDouble(0,1) < Cr)
-			x(j) = donor->X(j);
+void BinomialCrossoverManager::crossover(ArrayXXd const& targets, ArrayXXd const& donors, ArrayXd const& Crs, 
+		Indices const indices, Population& trials) const{
+	draw(targets, indices.size());
+	for (int j = 0; j < indices.size(); j++){
+		int const i = indices[j];
+		cross(j, targets.col(i), donors.col(i), Crs(i), trials.modifyX(i));
 	}
-	return new Solution(x);
 }
 
-Solution* ExponentialCrossoverManager::crossover(Solution const* const target, Solution const* const donor, double const Cr) const{
-	ArrayXd x = target->X();
-	int const start = rng.randInt(0,x.size()-1);
+void BinomialCrossoverManager::draw(ArrayXXd const& targets, int const n) const{
+	if (uniforms.rows() != targets.rows() || uniforms.cols() < n)
+		uniforms.resize(targets.rows(), targets.cols());
+	rng.fillUniform(uniforms.leftCols(n), 0, 1);
+}
 
-	int L = 1;
-	while (L < x.size() && rng.randDouble(0,1) < Cr)
-		L++;
+// A single pass over the coordinates, each taken from the donor or the target
+void BinomialCrossoverManager::cross(int const j, ConstColumn const& target, ConstColumn const& donor, double const Cr,
+		ArrayXXd::ColXpr trial) const{
+	trial = (uniforms.col(j) < Cr).select(donor, target);
+	int const jrand = rng.randInt(0,target.size()-1);
+	trial(jrand) = donor(jrand);
+}
 
-	int const end = (start+L-1) % x.size();
+Column BinomialCrossoverManager::getDonor(int const D) const{
+	if (donor.size() != D)
+		donor.resize(D);
+	return donor;
+}
 
-	auto const condition = end >= start ? \
-		[](int const i, int const start, int const end) {return i >= start && i <= end;}: 
-		[](int const i, int const start, int const end) {return i <= end || i >= start;};
+void ExponentialCrossoverManager::crossover(ArrayXXd const& targets, ArrayXXd const& donors, ArrayXd const& Crs, 
+		Indices const indices, Population& trials) const{
+	int const D = targets.rows();
+	for (int const i : indices){
+		int const start = rng.randInt(0,D-1);
 
-	for (unsigned int i = 0; i < x.size(); i++)
-		if (condition(i, start, end))
-			x(i) = donor->X(i);
+		// L-1 is the number of consecutive successes with probability Cr, capped at D-1. P(L-1 >= m) = Cr^m,
+		// which is also the distribution of floor(log(u)/log(Cr)), so a single draw suffices.
+		int L = D;
+		if (Crs(i) <= 0.)
+			L = 1;
+		else if (Crs(i) < 1.){
+			double const successes = std::floor(std::log(rng.randDouble(0,1)) / std::log(Crs(i)));
+			if (successes < D-1)
+				L = 1 + int(successes);
+		}
 
-	return new Solution(x);
+		// The donor segment [start, start+L) wraps around at most once
+		int const end = std::min(start+L, D), wrapped = start+L-end;
+		ArrayXXd::ColXpr trial = trials.modifyX(i);
+		trial.head(wrapped) = donors.col(i).head(wrapped);
+		trial.segment(wrapped, start-wrapped) = targets.col(i).segment(wrapped, start-wrapped);
+		trial.segment(start, end-start) = donors.col(i).segment(start, end-start);
+		trial.tail(D-end) = targets.col(i).tail(D-end);
+	}
 }
 
-Solution* ArithmeticCrossoverManager::crossover(Solution const* const target, Solution const* const donor, double const /*Cr*/) const{	
-	return new Solution(target->X() + rng.randDouble(0,1) * (donor->X() - target->X()));
+void ArithmeticCrossoverManager::crossover(ArrayXXd const& targets, ArrayXXd const& donors, ArrayXd const& /*Crs*/, 
+		Indices const indices, Population& trials) const{
+	for (int const i : indices)
+		trials.modifyX(i) = targets.col(i) + rng.randDouble(0,1) * (donors.col(i) - targets.col(i));
 }
@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <cmath>
 #include "differentialevolution.h"
 #include "params.h"
 #include "strategyadaptationmanager.h"
@@ -6,23 +7,46 @@
 #include "constrainthandler.h"
 #include "mutationmanager.h"
 #include "crossovermanager.h"
+#include "trialkernel.h"
+#include "threadpool.h"
+#include "islandmodel.h"
 #include "util.h"
+#include "checkpoint.h"
 
-DifferentialEvolution::DifferentialEvolution(std::string const id, DEConfig const config)
+DifferentialEvolution::DifferentialEvolution(std::string const id, DEConfig const config, int const threads)
 	:id(id), config(config), 
-	activationsLogger(params::extra_data_path + "/" + id + ".act"),
-	parameterLogger(params::extra_data_path + "/" + id + ".par"),
-	positionsLogger(params::extra_data_path + "/" + id + ".pos"),
-	diversityLogger(params::extra_data_path + "/" + id + ".div"),
-	repairsLogger(params::extra_data_path + "/" + id + ".rep"){
+	activationsLogger(params::extra_data_path + "/" + id + ".act", ACTIVATIONS),
+	parameterLogger(params::extra_data_path + "/" + id + ".par", PARAMETERS),
+	positionsLogger(params::extra_data_path + "/" + id + ".pos", POSITIONS),
+	diversityLogger(params::extra_data_path + "/" + id + ".div", DIVERSITY),
+	repairsLogger(params::extra_data_path + "/" + id + ".rep", REPAIRS),
+	threads(threads), pool(threads > 1 ? new ThreadPool(threads) : nullptr), model(nullptr), island(0), nextCheckpoint(0){
 }
 
-DifferentialEvolution::~DifferentialEvolution(){}
+DifferentialEvolution::~DifferentialEvolution(){
+	delete pool;
+}
 
-bool DifferentialEvolution::converged(std::vector<Solution*>const& population) const{
-	return std::abs(getWorst(population)->getFitness() - getBest(population)->getFitness()) < params::convergence_delta;
+bool DifferentialEvolution::converged(Population const& population) const{
+	return std::abs(population.getFitness(getWorst(population)) - population.getFitness(getBest(population))) 
+		< params::convergence_delta;
 } 
 
+void DifferentialEvolution::join(IslandModel* const model, int const island){
+	this->model = model;
+	this->island = island;
+}
+
+void DifferentialEvolution::setCheckpoint(std::function<void()> const save){
+	checkpoint = save;
+}
+
+bool DifferentialEvolution::exhausted(int const evalBudget) const{
+	if (model)
+		return model->exhausted();
+	return (int)coco_problem_get_evaluations(problem) >= evalBudget || coco_problem_final_target_hit(problem);
+}
+
 // Should be called before starting to optimize a problem
 void DifferentialEvolution::prepare(coco_problem_t* const problem, int const popSize) {
 	this->D = coco_problem_get_dimension(problem);
@@ -34,37 +58,102 @@ void DifferentialEvolution::prepare(coco_problem_t* const problem, int const pop
 		upperBound = ArrayXd::Map(coco_problem_get_largest_values_of_interest(problem), D);
 
 	// Initialize and evaluate the population
-	genomes.resize(popSize);
-	for (int i = 0; i < popSize; i++){
-		genomes[i] = new Solution(D);
-		genomes[i]->randomize(lowerBound, upperBound);
-		genomes[i]->evaluate(problem);
-	}
+	genomes.resize(D, popSize);
+	trials.resize(D, popSize);
+	donors.resize(D, popSize);
+	values.resize(popSize);
+	for (int i = 0; i < popSize; i++)
+		genomes.randomize(i, lowerBound, upperBound);
+	if (model){ // Individuals beyond the budget left are not computed: the island stops before using them
+		int const granted = model->reserve(popSize);
+		for (int i = granted; i < popSize; i++)
+			genomes.setFitness(i, INFINITY);
+		genomes.compute(problem);
+		model->commit(genomes, range(granted));
+	} else
+		genomes.evaluate(problem);
 
 	ch = ConstraintHandler::create(config.constraintHandler)(lowerBound, upperBound);
 	strategyAdaptationManager = StrategyAdaptationManager::create(config.strategy)(
 			config.strategyAdaptationConfig, ch, genomes);
+	iteration = 0;
+	recentActivations = ArrayXi::Zero(strategyAdaptationManager->K);
+	nextCheckpoint = coco_problem_get_evaluations(problem) + params::checkpoint_interval;
 
-	if (params::log_activations){
-		activationsLogger.log(coco_problem_get_id(problem), false);
-		for (std::string const& s : strategyAdaptationManager->getConfigurationIDs())
-			activationsLogger.log(" " + s, false);
-		activationsLogger.log("");
-	}
+	std::string const problemID = coco_problem_get_id(problem);
+	if (params::log_activations)
+		activationsLogger.begin(problemID, D, popSize, params::log_activations_interval,
+				strategyAdaptationManager->getConfigurationIDs());
 
 	if (params::log_parameters)
-		parameterLogger.log(coco_problem_get_id(problem));
+		parameterLogger.begin(problemID, D, popSize, params::log_parameters_interval);
+
+	if (params::log_positions)
+		positionsLogger.begin(problemID, D, popSize, params::log_positions_interval);
 
 	if (params::log_diversity)
-		diversityLogger.log(coco_problem_get_id(problem));
+		diversityLogger.begin(problemID, D, popSize, params::log_diversity_interval);
 
 	if (params::log_repairs)
-		repairsLogger.log(coco_problem_get_id(problem));
+		repairsLogger.begin(problemID, D, popSize, params::log_repairs_interval);
 }
 
 // Wrapper of prepare -> run -> reset
 void DifferentialEvolution::run(coco_problem_t* problem, int const evalBudget, int const popSize){
 	prepare(problem, popSize);
+	if (params::asynchronous)
+		runAsynchronous(evalBudget);
+	else
+		run(evalBudget);
+	reset();
+}
+
+// The state of a run between two generations. The COCO problem and the random stream are saved by the caller.
+void DifferentialEvolution::save(Checkpoint& checkpoint){
+	checkpoint.write(popSize);
+	checkpoint.write(iteration);
+	checkpoint.write(recentActivations);
+	genomes.save(checkpoint);
+	ch->save(checkpoint);
+	strategyAdaptationManager->save(checkpoint);
+	for (ExtraDataLog* const logger : {&activationsLogger, &parameterLogger, &positionsLogger, &diversityLogger, 
+			&repairsLogger})
+		logger->save(checkpoint);
+}
+
+// As prepare(), from a saved state instead of a new population, on the problem restored by the caller
+void DifferentialEvolution::restore(coco_problem_t* const problem, Checkpoint& checkpoint){
+	this->D = coco_problem_get_dimension(problem);
+	this->problem = problem;
+	checkpoint.read(popSize);
+	checkpoint.read(iteration);
+	checkpoint.read(recentActivations);
+
+	ArrayXd const 
+		lowerBound = ArrayXd::Map(coco_problem_get_smallest_values_of_interest(problem), D),
+		upperBound = ArrayXd::Map(coco_problem_get_largest_values_of_interest(problem), D);
+
+	genomes.restore(checkpoint);
+	if (genomes.dimension() != D || genomes.size() != popSize)
+		throw std::invalid_argument("Checkpoint of another problem: " + std::string(coco_problem_get_id(problem)));
+	trials.resize(D, popSize);
+	donors.resize(D, popSize);
+	values.resize(popSize);
+
+	ch = ConstraintHandler::create(config.constraintHandler)(lowerBound, upperBound);
+	ch->restore(checkpoint);
+	strategyAdaptationManager = StrategyAdaptationManager::create(config.strategy)(
+			config.strategyAdaptationConfig, ch, genomes);
+	strategyAdaptationManager->restore(checkpoint);
+	for (ExtraDataLog* const logger : {&activationsLogger, &parameterLogger, &positionsLogger, &diversityLogger, 
+			&repairsLogger})
+		logger->restore(checkpoint);
+	nextCheckpoint = coco_problem_get_evaluations(problem) + params::checkpoint_interval;
+}
+
+void DifferentialEvolution::resume(coco_problem_t* problem, int const evalBudget, Checkpoint& checkpoint){
+	assert(!params::asynchronous && !model);
+	restore(problem, checkpoint);
 	run(evalBudget);
 	reset();
 }
@@ -73,97 +162,231 @@ void DifferentialEvolution::run(coco_problem_t* problem, int const evalBudget, i
 void DifferentialEvolution::run(int const evalBudget){
 	ArrayXd Fs(popSize), Crs(popSize);
 
-	std::map<MutationManager*, std::vector<int>> mutationManagers;   // Maps containing the indices that each
-	std::map<CrossoverManager*, std::vector<int>> crossoverManagers; // mutation/crossover operator handles.
-
-	ArrayXi recentActivations = ArrayXi::Zero(strategyAdaptationManager->K);
-
-	int iteration = 0;
-	while ((int)coco_problem_get_evaluations(problem) < evalBudget
-			&& !coco_problem_final_target_hit(problem)
-			&& (!params::restart_on_convergence || !converged(genomes))){
+	Buckets assignment; // The indices that each configuration handles
+	std::vector<MutationManager*> prepared;
 
-		strategyAdaptationManager->next(genomes, mutationManagers, crossoverManagers, Fs, Crs);
-		recentActivations += strategyAdaptationManager->getLastActivations();
+	std::vector<std::tuple<MutationManager*, CrossoverManager*>> const& configurations =
+		strategyAdaptationManager->getConfigurations();
+	std::vector<TrialKernel> const& trialKernels = strategyAdaptationManager->getTrialKernels();
 
-		// Mutation step
-		std::vector<Solution*> donors(popSize);
-		for (auto iter = mutationManagers.begin(); iter != mutationManagers.end(); iter++){
-			MutationManager* const m = iter->first;
-			m->prepare(genomes);
-			for (int const i : iter->second)
-				 donors[i] = m->mutate(genomes, i, Fs[i]);
+	while (!exhausted(evalBudget) && (!params::restart_on_convergence || !converged(genomes))){
+		if (checkpoint && params::checkpoint_interval > 0 && coco_problem_get_evaluations(problem) >= nextCheckpoint){
+			checkpoint();
+			nextCheckpoint = coco_problem_get_evaluations(problem) + params::checkpoint_interval;
 		}
 
-		// Crossover step
-		std::vector<Solution*> trials(popSize); 
-		for (auto iter = crossoverManagers.begin(); iter != crossoverManagers.end(); iter++){
-			CrossoverManager* c = iter->first;
-			for (int const i : iter->second){
-				trials[i] = c->crossover(genomes[i], donors[i], Crs[i]);
-				delete donors[i];
+		strategyAdaptationManager->next(genomes, assignment, Fs, Crs);
+		strategyAdaptationManager->addLastActivations(recentActivations);
 
-				trials[i]->evaluate(problem);
-				ch->penalize(trials[i]); 
+		// Mutation operators shared by several configurations are prepared only once
+		prepared.clear();
+		for (int k = 0; k < strategyAdaptationManager->K; k++){
+			MutationManager* const m = std::get<0>(configurations[k]);
+			if (!assignment[k].empty() && std::find(prepared.begin(), prepared.end(), m) == prepared.end()){
+				m->prepare(genomes);
+				prepared.push_back(m);
 			}
 		}
 
+		// Trial generation: each configuration runs its own specialized kernel over its individuals
+		for (int k = 0; k < strategyAdaptationManager->K; k++){
+			if (!assignment[k].empty())
+				trialKernels[k](*std::get<0>(configurations[k]), *std::get<1>(configurations[k]), 
+						genomes, assignment[k], Fs, Crs, donors, trials);
+		}
+
+		evaluateTrials();
+		for (int i = 0; i < popSize; i++)
+			ch->penalize(trials, i); 
+
 		// Update the adaptation manager
 		strategyAdaptationManager->update(trials);
 
-		if (params::log_parameters && iteration % params::log_parameters_interval == 0){
-			for (int i = 0; i < popSize; i++){
-				parameterLogger.log(int(Fs(i)*100), false);
-				parameterLogger.log(":", false);
-				parameterLogger.log(int(Crs(i)*100), false);
-				if (i != popSize-1)
-					parameterLogger.log(" ", false);
-			}
-			parameterLogger.log("");
+		// Selection step: improved trials are swapped into the population
+		for (int i = 0; i < popSize; i++){
+			if (trials.getFitness(i) < genomes.getFitness(i))
+				genomes.swap(i, trials);
 		}
 
+		// Island model: exchange the best individuals with the neighbouring islands
+		if (model && (iteration+1) % params::migration_interval == 0)
+			model->migrate(island, genomes);
+
+		log(iteration, Fs, Crs, recentActivations);
+		iteration++;
+	}
+}
 
-		// Selection step
+void DifferentialEvolution::log(int const iteration, ArrayXd const& Fs, ArrayXd const& Crs, 
+		ArrayXi& recentActivations){
+	if (params::log_parameters && iteration % params::log_parameters_interval == 0){
+		parameters.resize(2 * popSize);
 		for (int i = 0; i < popSize; i++){
-			if (*trials[i] < *genomes[i]){
-				delete genomes[i];
-				genomes[i] = trials[i];
-			} else {
-				delete trials[i];
-			}
+			parameters(2*i) = int(Fs(i)*100);
+			parameters(2*i+1) = int(Crs(i)*100);
 		}
+		parameterLogger.record(iteration, parameters.data());
+	}
+
+	if (params::log_activations && iteration > 0 && iteration % params::log_activations_interval == 0){
+		activationsLogger.record(iteration, recentActivations.data());
+		recentActivations.setZero();
+	}
+
+	if (params::log_diversity && iteration % params::log_diversity_interval == 0){
+		double const diversity = strategyAdaptationManager->getDistancesToMeanPosition().mean();
+		diversityLogger.record(iteration, &diversity);
+	}
+
+	if (params::log_positions && iteration % params::log_positions_interval == 0)
+		positionsLogger.record(iteration, genomes.X().data());
+
+	if (params::log_repairs && iteration > 0 && iteration % params::log_repairs_interval == 0){
+		double const repairs = double(ch->getCorrections()) / (int)coco_problem_get_evaluations(problem);
+		repairsLogger.record(iteration, &repairs);
+	}
+}
+
+// Steady-state variant of run(), without a generational barrier: worker threads compute trials on the shared
+// problem while this thread generates them. As soon as a trial is done, it is committed, reported
+// to the adaptation manager and selected against its target, and a new trial is generated for the next target
+// without one in flight, from the current population. Every popSize trials count as a generation: the mutation
+// operators are prepared again, convergence is checked and the logs are written.
+void DifferentialEvolution::runAsynchronous(int const evalBudget){
+	assert(!model);
+	ArrayXd Fs = ArrayXd::Zero(popSize), Crs = ArrayXd::Zero(popSize);
+	std::vector<bool> pending(popSize, false); // Targets with a trial in flight
+	ArrayXd sum = genomes.X().rowwise().sum(), mean(D);
+
+	std::vector<std::tuple<MutationManager*, CrossoverManager*>> const& configurations =
+		strategyAdaptationManager->getConfigurations();
+	std::vector<TrialKernel> const& trialKernels = strategyAdaptationManager->getTrialKernels();
+	std::vector<MutationManager*> const mutationManagers = strategyAdaptationManager->getMutationManagers();
+	for (MutationManager* const m : mutationManagers)
+		m->prepare(genomes);
 
-		/* Logging */
-		if (params::log_activations && iteration > 0 && iteration % params::log_activations_interval == 0){
-			activationsLogger.log(recentActivations.transpose().format(params::vecFmt));
-			recentActivations.setZero();
+	int const workers = std::max(1, std::min(threads, popSize));
+	AsyncExecutor executor(workers, [this](int const, int const i){
+		coco_compute_function(problem, trials.X(i).data(), &values(i));
+	});
+
+	int next = 0, inFlight = 0, completed = 0;
+	bool stop = false;
+	auto const generate = [&](){
+		while (pending[next])
+			next = (next+1) % popSize;
+		int const i = next;
+		next = (next+1) % popSize;
+
+		mean = sum / popSize;
+		int const k = strategyAdaptationManager->next(genomes, mean, i, Fs(i), Crs(i));
+		trialKernels[k](*std::get<0>(configurations[k]), *std::get<1>(configurations[k]), 
+				genomes, Indices(&i, &i+1), Fs, Crs, donors, trials); // Trials are generated one at a time
+		pending[i] = true;
+		inFlight++;
+		executor.submit(i);
+	};
+	auto const budgetLeft = [&](){
+		return (int)coco_problem_get_evaluations(problem) + inFlight < evalBudget;
+	};
+
+	while (inFlight < workers && budgetLeft())
+		generate();
+
+	while (inFlight > 0){
+		int const i = executor.wait();
+		pending[i] = false;
+		inFlight--;
+
+		trials.commit(i, problem, values(i));
+		ch->penalize(trials, i);
+		mean = sum / popSize;
+		strategyAdaptationManager->update(trials, mean, i);
+		if (trials.getFitness(i) < genomes.getFitness(i)){
+			sum += trials.X(i) - genomes.X(i);
+			genomes.swap(i, trials);
 		}
 
-		if (params::log_diversity && iteration % params::log_diversity_interval == 0)
-			diversityLogger.log(strategyAdaptationManager->getDistancesToMeanPosition().mean());
+		if (++completed % popSize == 0){
+			strategyAdaptationManager->addLastActivations(recentActivations);
+			log(iteration, Fs, Crs, recentActivations);
+			iteration++;
 
-		if (params::log_positions && iteration % params::log_positions_interval == 0){
-			for (Solution const* const s : genomes)
-				positionsLogger.log(s->X().transpose().format(params::vecFmt));
-			positionsLogger.log("");
+			stop = params::restart_on_convergence && converged(genomes);
+			sum = genomes.X().rowwise().sum(); // Drops the rounding errors of the incremental updates
+			for (MutationManager* const m : mutationManagers)
+				m->prepare(genomes);
 		}
 
-		if (params::log_repairs && iteration > 0 && iteration % params::log_repairs_interval == 0)
-			repairsLogger.log(double(ch->getCorrections()) / (int)coco_problem_get_evaluations(problem));
-		/* ----- */
-		iteration++;
+		if (!stop && !coco_problem_final_target_hit(problem) && budgetLeft())
+			generate();
+	}
+}
+
+// The trials are evaluated in batches of adjacent columns, so the COCO transformation chain is traversed once
+// per batch rather than once per trial. With a thread pool, the batches are computed concurrently on the shared
+// problem, whose transformations then work on buffers of their own. The values are then committed to the observed
+// problem in index order, so COCO sees the same evaluations as in a serial run. Islands reserve their evaluations
+// from the model before computing them, and the model commits them.
+void DifferentialEvolution::evaluateTrials(){
+	if (model){
+		fresh.clear();
+		for (int i = 0; i < popSize; i++)
+			if (!trials.isEvaluated(i))
+				fresh.push_back(i);
+		// The generation that spends the shared budget is cut to what is left of it: the trials beyond are
+		// copies of their targets, which are not computed and cannot be selected
+		int const granted = model->reserve(fresh.size());
+		for (int k = granted; k < (int)fresh.size(); k++){
+			trials.setX(fresh[k], genomes.X(fresh[k]));
+			trials.setFitness(fresh[k], genomes.getFitness(fresh[k]));
+		}
+		fresh.resize(granted);
+	}
+
+	if (!pool){
+		if (model)
+			trials.compute(problem);
+		else
+			trials.evaluate(problem);
+	} else {
+		int const chunk = std::max(1, popSize / (4 * pool->size())); // Several chunks per thread for balance
+		pool->run((popSize + chunk - 1) / chunk, [this, chunk](int const, int const c){
+			int const end = std::min(popSize, (c+1) * chunk);
+			for (int i = c * chunk; i < end; i++){
+				if (trials.isEvaluated(i))
+					continue;
+				int last = i;
+				while (last+1 < end && !trials.isEvaluated(last+1))
+					last++;
+				coco_compute_function_batch(problem, trials.X(i).data(), last-i+1, &values(i));
+				i = last;
+			}
+		});
+
+		for (int i = 0; i < popSize; i++)
+			if (!trials.isEvaluated(i)){
+				if (model)
+					trials.setFitness(i, values(i));
+				else
+					trials.commit(i, problem, values(i));
+			}
 	}
+
+	if (model)
+		model->commit(trials, fresh);
 }
 
 void DifferentialEvolution::reset(){
-	if (params::log_activations) activationsLogger.log(""); // blank line
-	if (params::log_parameters) parameterLogger.log(""); 
-	if (params::log_diversity) diversityLogger.log("");
-	if (params::log_repairs) repairsLogger.log("");
+	if (params::log_activations) activationsLogger.end();
+	if (params::log_parameters) parameterLogger.end();
+	if (params::log_positions) positionsLogger.end();
+	if (params::log_diversity) diversityLogger.end();
+	if (params::log_repairs) repairsLogger.end();
 
-	for (Solution* d : genomes) 
-		delete d;
 	delete ch;
 	delete strategyAdaptationManager;
-	genomes.clear();
+	genomes.resize(0, 0);
+	trials.resize(0, 0);
+	donors.resize(0, 0);
 }
@@ -1,17 +1,64 @@
 #include <iostream>
+#include <fstream>
+#include <sstream>
 #include <functional>
+#include <stdexcept>
 #include <getopt.h>
 #include "coco.h"
+#include "campaign.h"
+#include "checkpoint.h"
 #include "differentialevolution.h"
+#include "islandmodel.h"
 #include "params.h"
 
-static coco_problem_t *PROBLEM;
 static int BUDGET_MULTIPLIER = 1e5;
 static int INDEPENDENT_RUNS = 20;
 static std::vector<std::string> INSTANCES = {"1","2","3","4","5"};
+static int JOBS = 1;
+static std::string RNG_ENGINE = "XO";
+static std::string OBSERVER = "bbob";
+static bool SEEDED = false;
+static uint64_t SEED;
 
 #include "default_params.h"
 
+// Time in ns per evaluation and coordinate of the bbob functions f1..f24 (BBOB_COST), and of the algorithm's
+// own work per trial and coordinate (DE_COST). They only order the tasks of a campaign, so only their ratios
+// matter: these defaults, measured by bench/costs at 40-D with the avx2 kernels on one machine, are relative
+// weights. --costs replaces them by the output of `make bench && ./costs` on the machine running the campaign.
+static double DE_COST = 110.5;
+static double BBOB_COST[24] = {
+	10.8, 121.6, 156.1, 163.1, 37.9, 30.8, 160.5, 25.6, 22.4, 152.6, 148.6, 33.1,
+	20.9, 35.2, 157.4, 385.1, 133.8, 155.7, 45.2, 65.1, 264.3, 87.1, 1121.8, 153.3
+};
+
+// Reads the output of ./costs: DE_COST then BBOB_COST, separated by whitespace, after # comment lines
+void loadCosts(std::string const path){
+	std::ifstream file(path);
+	if (!file)
+		throw std::invalid_argument("Cannot open the costs file " + path);
+	std::vector<double> costs;
+	std::string line;
+	while (std::getline(file, line)){
+		if (line.empty() || line[0] == '#')
+			continue;
+		std::istringstream values(line);
+		double value;
+		while (values >> value)
+			costs.push_back(value);
+	}
+	if (costs.size() != 25)
+		throw std::invalid_argument("The costs file " + path + " does not hold the 25 costs printed by ./costs");
+	DE_COST = costs[0];
+	std::copy(costs.begin() + 1, costs.end(), BBOB_COST);
+}
+
+// Expected running time of a task in ns: the budget scales with the dimension, and so does the cost per evaluation
+double expectedCost(CampaignTask const& task){
+	double const evaluation = task.function >= 1 && task.function <= 24 ? BBOB_COST[task.function-1] : 0;
+	return (double)task.dimension * task.dimension * BUDGET_MULTIPLIER * (DE_COST + evaluation);
+}
+
 std::string gen_instances(){
 	std::string instances = "";
 	for (std::string i : INSTANCES)
@@ -21,29 +68,48 @@ std::string gen_instances(){
 	return instances;
 }
 
-void experiment(DifferentialEvolution& de,
+void experiment(DEConfig const& config,
+				std::string const id,
 				char const *const suite_name,
 				char const *const suite_options,
-				char const *const observer_name,
-				char const *const observer_options) {
+				char const *const observer_name) {
+
+	Campaign campaign(suite_name, "instances: " + gen_instances(), suite_options, observer_name, id);
 
-	coco_suite_t *suite;
-	coco_observer_t *observer;
-	suite = coco_suite(suite_name, ("instances: " + gen_instances()).c_str(), suite_options);
-	observer = coco_observer(observer_name, observer_options);
+	// Each run has its own random stream. With a fixed seed, the results do not depend on the number of jobs.
+	// A run resumed from a checkpoint continues its stream, so it ends as if it had not been interrupted.
+	campaign.run(JOBS, expectedCost, [&config](CampaignTask const& task, coco_problem_t* const problem){
+		rng.setEngine(RNG_ENGINE);
+		if (SEEDED)
+			rng.seed(SEED + task.index);
+		else
+			rng.seed();
 
-	while ((PROBLEM = coco_suite_get_next_problem(suite, observer))) {
-		int const dimension = coco_problem_get_dimension(PROBLEM);
+		int const dimension = coco_problem_get_dimension(problem);
 		int const popSize = dimension * params::popsize_multiplier;
 		size_t const budget = dimension * BUDGET_MULTIPLIER;
 
-		do {
-			de.run(PROBLEM, budget, popSize);
-		} while (!coco_problem_final_target_hit(PROBLEM) && coco_problem_get_evaluations(PROBLEM) < budget);
-	}
+		if (params::islands > 1){ // Islands restart individually until the shared budget is spent
+			IslandModel islands(task.id, config, params::islands, params::topology);
+			islands.run(problem, budget, popSize);
+			return;
+		}
 
-	coco_observer_free(observer);
-	coco_suite_free(suite);
+		DifferentialEvolution de(task.id, config);
+		if (!task.checkpoint.empty())
+			de.setCheckpoint([&task, &de, problem](){
+				task.save(problem, [&de](Checkpoint& checkpoint){
+					rng.save(checkpoint);
+					de.save(checkpoint);
+				});
+			});
+		if (task.resumed){
+			rng.restore(*task.resumed);
+			de.resume(problem, budget, *task.resumed);
+		}
+		while (!coco_problem_final_target_hit(problem) && coco_problem_get_evaluations(problem) < budget)
+			de.run(problem, budget, popSize);
+	});
 }
 
 std::vector<std::string> splitString(std::string str){
@@ -70,7 +136,8 @@ int main(int argc, char** argv){
 	  	dimensions 	= "20",
 		functions 	= "1-24",
 		id = "DE",
-		coco_log_level = "info";
+		coco_log_level = "info",
+		simd = "auto";
 
 	std::vector<std::string> 
 		mutation = {"RA1"}, 
@@ -98,6 +165,24 @@ int main(int argc, char** argv){
 #define BUDGET_MULTIPLIER_FLAG 1017
 #define INDEPENDENT_RUNS_FLAG 1018
 #define COCO_LOG_LEVEL_FLAG 1019
+#define RNG_FLAG 1020
+#define SEED_FLAG 1021
+#define THREADS_FLAG 1022
+#define JOBS_FLAG 1023
+#define ISLANDS_FLAG 1024
+#define TOPOLOGY_FLAG 1025
+#define MIGRATION_INTERVAL_FLAG 1026
+#define MIGRATION_SIZE_FLAG 1027
+#define ASYNCHRONOUS_FLAG 1028
+#define SIMD_FLAG 1029
+#define LOG_BUFFER_FLAG 1030
+#define LOG_POLICY_FLAG 1031
+#define LOG_FORMAT_FLAG 1032
+#define OBSERVER_FLAG 1033
+#define CHECKPOINT_INTERVAL_FLAG 1034
+#define CHECKPOINT_PATH_FLAG 1035
+#define RESUME_FLAG 1036
+#define COSTS_FLAG 1037
 
 	while(true){	
 		static struct option long_options[] =
@@ -124,12 +209,30 @@ int main(int argc, char** argv){
 			{"budget-multiplier", required_argument, 0, BUDGET_MULTIPLIER_FLAG},
 			{"independent-runs", required_argument, 0, INDEPENDENT_RUNS_FLAG},
 			{"coco-log-level", required_argument, 0, COCO_LOG_LEVEL_FLAG},
+			{"simd", required_argument, 0, SIMD_FLAG},
+			{"observer", required_argument, 0, OBSERVER_FLAG},
+			{"rng", required_argument, 0, RNG_FLAG},
+			{"seed", required_argument, 0, SEED_FLAG},
+			{"threads", required_argument, 0, THREADS_FLAG},
+			{"jobs", required_argument, 0, JOBS_FLAG},
+			{"islands", required_argument, 0, ISLANDS_FLAG},
+			{"topology", required_argument, 0, TOPOLOGY_FLAG},
+			{"migration-interval", required_argument, 0, MIGRATION_INTERVAL_FLAG},
+			{"migration-size", required_argument, 0, MIGRATION_SIZE_FLAG},
+			{"asynchronous", no_argument, 0, ASYNCHRONOUS_FLAG},
+			{"checkpoint-interval", required_argument, 0, CHECKPOINT_INTERVAL_FLAG},
+			{"checkpoint-path", required_argument, 0, CHECKPOINT_PATH_FLAG},
+			{"resume", no_argument, 0, RESUME_FLAG},
+			{"costs", required_argument, 0, COSTS_FLAG},
 
 			{"log-activations", optional_argument, 0, LOG_ACTIVATIONS_FLAG},
 			{"log-parameters", optional_argument, 0, LOG_PARAMETERS_FLAG},
 			{"log-positions", optional_argument, 0, LOG_POSITIONS_FLAG},
 			{"log-diversity", optional_argument, 0, LOG_DIVERSITY_FLAG},
 			{"log-repairs", optional_argument, 0, LOG_REPAIRS_FLAG},
+			{"log-buffer", required_argument, 0, LOG_BUFFER_FLAG},
+			{"log-policy", required_argument, 0, LOG_POLICY_FLAG},
+			{"log-format", required_argument, 0, LOG_FORMAT_FLAG},
 			{0, 0, 0, 0}
 		};
 
@@ -164,6 +267,21 @@ int main(int argc, char** argv){
 			case BUDGET_MULTIPLIER_FLAG: BUDGET_MULTIPLIER = std::stoi(optarg); break;
 			case INDEPENDENT_RUNS_FLAG: INDEPENDENT_RUNS = std::stoi(optarg); break;
 			case COCO_LOG_LEVEL_FLAG: coco_log_level = optarg; break;
+			case SIMD_FLAG: simd = optarg; break;
+			case OBSERVER_FLAG: OBSERVER = optarg; break;
+			case RNG_FLAG: RNG_ENGINE = optarg; rng.setEngine(RNG_ENGINE); break; // Fails early on unknown engines
+			case SEED_FLAG: SEED = std::stoull(optarg); SEEDED = true; break;
+			case THREADS_FLAG: params::threads = std::stoi(optarg); break;
+			case JOBS_FLAG: JOBS = std::stoi(optarg); break;
+			case ISLANDS_FLAG: params::islands = std::stoi(optarg); break;
+			case TOPOLOGY_FLAG: params::topology = optarg; break;
+			case MIGRATION_INTERVAL_FLAG: params::migration_interval = std::stoi(optarg); break;
+			case MIGRATION_SIZE_FLAG: params::migration_size = std::stoi(optarg); break;
+			case ASYNCHRONOUS_FLAG: params::asynchronous = true; break;
+			case CHECKPOINT_INTERVAL_FLAG: params::checkpoint_interval = std::stoi(optarg); break;
+			case CHECKPOINT_PATH_FLAG: params::checkpoint_path = optarg; break;
+			case RESUME_FLAG: params::resume = true; break;
+			case COSTS_FLAG: loadCosts(optarg); break;
 
 			case LOG_ACTIVATIONS_FLAG: 
 				params::log_activations = true; 
@@ -185,34 +303,39 @@ int main(int argc, char** argv){
 				params::log_repairs = true; 
 				if (optarg) params::log_repairs_interval = std::stoi(optarg);
 				break;
+			case LOG_BUFFER_FLAG: params::log_buffer = std::stoi(optarg); break;
+			case LOG_POLICY_FLAG: params::log_policy = optarg; break;
+			case LOG_FORMAT_FLAG: params::log_format = optarg; break;
 		}
 	}
 
+	// Only generational runs of a single population save their state between two generations
+	if ((params::checkpoint_interval > 0 || params::resume) && (params::asynchronous || params::islands > 1))
+		throw std::invalid_argument("--checkpoint-interval and --resume do not support --asynchronous or --islands");
+
 	coco_set_log_level(coco_log_level.c_str());
+	coco_set_simd_level(simd.c_str());
 
-	DifferentialEvolution de (
-		id, 
-		{
-			.strategy = strategy,
-			.constraintHandler = constraint,
-			.strategyAdaptationConfig = { 
-				.mutation = mutation,
-				.crossover = crossover,
-				.param = param,
-				.credit = credit,
-				.reward = reward,
-				.quality = quality,
-				.probability = probability
-			}
+	DEConfig const config = {
+		.strategy = strategy,
+		.constraintHandler = constraint,
+		.strategyAdaptationConfig = { 
+			.mutation = mutation,
+			.crossover = crossover,
+			.param = param,
+			.credit = credit,
+			.reward = reward,
+			.quality = quality,
+			.probability = probability
 		}
-	);
+	};
 
 	experiment(
-		de, 
+		config, 
+		id,
 		"bbob", 
 		("dimensions: " + dimensions + " function_indices: " + functions).c_str(), 
-		"bbob", 
-		("result_folder: " + id).c_str()
+		OBSERVER.c_str()
 	);
 
 	return 0;
@@ -0,0 +1,248 @@
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "checkpoint.h"
+#include "extradata.h"
+#include "params.h"
+
+static char const MAGIC[4] = {'D', 'E', 'X', 'D'};
+static uint32_t const VERSION = 1;
+static int32_t const SECTION_END = -1;
+
+static_assert(sizeof(int) == sizeof(int32_t), "The int32 records are written from int arrays");
+
+ExtraDataLog::ExtraDataLog(std::string const filename, ExtraDataKind const kind)
+	:ExtraDataLog(filename, kind, params::log_format == "BINARY"){
+	if (params::log_format != "TEXT" && params::log_format != "BINARY")
+		throw std::invalid_argument("no such log format: " + params::log_format);
+}
+
+ExtraDataLog::ExtraDataLog(std::string const filename, ExtraDataKind const kind, bool const binary)
+	:logger(binary ? filename + ".bin" : filename), kind(kind), binary(binary){
+}
+
+int ExtraDataLog::columns() const {
+	switch (kind){
+		case PARAMETERS: return 2 * NP;
+		case POSITIONS: return D * NP;
+		case DIVERSITY: case REPAIRS: return 1;
+		default: return configurations;
+	}
+}
+
+void ExtraDataLog::writeString(std::string const& s){
+	uint32_t const n = s.size();
+	logger.write(&n, sizeof(n), false, false);
+	logger.write(s.data(), n, false, false);
+}
+
+// Headers and section ends are never dropped, so that a binary file can always be parsed
+void ExtraDataLog::begin(std::string const& problem, int const D, int const NP, int const interval,
+		std::vector<std::string> const& configurations){
+	this->D = D;
+	this->NP = NP;
+	this->configurations = configurations.size();
+	if (!binary && kind == POSITIONS)
+		return; // Only the blank line after each generation separates the text positions
+	if (!binary){
+		logger.log(problem, kind != ACTIVATIONS);
+		if (kind == ACTIVATIONS){
+			for (std::string const& s : configurations)
+				logger.log(" " + s, false);
+			logger.log("");
+		}
+		return;
+	}
+
+	if (!started){
+		int32_t const k = kind;
+		logger.write(MAGIC, sizeof(MAGIC), false, false);
+		logger.write(&VERSION, sizeof(VERSION), false, false);
+		logger.write(&k, sizeof(k), false, false);
+		started = true;
+	}
+	writeString(problem);
+	int32_t const header[] = {D, NP, interval, int32_t(configurations.size())};
+	logger.write(header, sizeof(header), false, false);
+	for (std::string const& s : configurations)
+		writeString(s);
+	int32_t const layout[] = {kind == POSITIONS || kind == DIVERSITY || kind == REPAIRS, columns()};
+	logger.write(layout, sizeof(layout), true, false);
+}
+
+void ExtraDataLog::record(int const generation, int const* values){
+	int const n = columns();
+	if (binary){
+		logger.write(&generation, sizeof(generation), false);
+		logger.write(values, n * sizeof(int));
+	} else if (kind == PARAMETERS){
+		for (int i = 0; i < NP; i++){
+			logger.log(values[2*i], false);
+			logger.log(":", false);
+			logger.log(values[2*i+1], false);
+			if (i != NP-1)
+				logger.log(" ", false);
+		}
+		logger.log("");
+	} else
+		logger.log(Eigen::Map<ArrayXi const>(values, n), params::vecFmt);
+}
+
+void ExtraDataLog::record(int const generation, double const* values){
+	if (binary){
+		logger.write(&generation, sizeof(generation), false);
+		logger.write(values, columns() * sizeof(double));
+	} else if (kind == POSITIONS){
+		for (int i = 0; i < NP; i++)
+			logger.log(Eigen::Map<ArrayXd const>(values + i * D, D), params::vecFmt);
+		logger.log("");
+	} else
+		logger.log(values[0]);
+}
+
+void ExtraDataLog::end(){
+	if (binary)
+		logger.write(&SECTION_END, sizeof(SECTION_END), true, false);
+	else if (kind != POSITIONS)
+		logger.log("");
+}
+
+void ExtraDataLog::save(Checkpoint& checkpoint){
+	logger.save(checkpoint);
+	checkpoint.write(started);
+	checkpoint.write(D);
+	checkpoint.write(NP);
+	checkpoint.write(configurations);
+}
+
+void ExtraDataLog::restore(Checkpoint& checkpoint){
+	logger.restore(checkpoint);
+	checkpoint.read(started);
+	checkpoint.read(D);
+	checkpoint.read(NP);
+	checkpoint.read(configurations);
+}
+
+int ExtraDataSection::generation(std::size_t const record) const {
+	int32_t g;
+	std::memcpy(&g, records + record * (sizeof(int32_t) + columns * (floating ? 8 : 4)), sizeof(g));
+	return g;
+}
+
+double ExtraDataSection::value(std::size_t const record, int const column) const {
+	char const* const p = records + record * (sizeof(int32_t) + columns * (floating ? 8 : 4)) + sizeof(int32_t);
+	if (floating){
+		double v;
+		std::memcpy(&v, p + column * sizeof(double), sizeof(v));
+		return v;
+	}
+	int32_t v;
+	std::memcpy(&v, p + column * sizeof(int32_t), sizeof(v));
+	return v;
+}
+
+ExtraDataReader::ExtraDataReader(std::string const filename)
+	:data(nullptr), size(0){
+	int const fd = open(filename.c_str(), O_RDONLY);
+	if (fd < 0)
+		throw std::invalid_argument("Failed to open file " + filename);
+	struct stat status;
+	if (fstat(fd, &status) == 0 && status.st_size > 0){
+		size = status.st_size;
+		void* const mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+		data = mapping == MAP_FAILED ? nullptr : static_cast<char const*>(mapping);
+	}
+	close(fd);
+	if (!data)
+		throw std::invalid_argument("Failed to map file " + filename);
+
+	std::size_t position = 0;
+	auto const read = [&](void* value, std::size_t const n){
+		if (position + n > size)
+			return false;
+		std::memcpy(value, data + position, n);
+		position += n;
+		return true;
+	};
+	auto const readString = [&](std::string& s){
+		uint32_t n;
+		if (!read(&n, sizeof(n)) || position + n > size)
+			return false;
+		s.assign(data + position, n);
+		position += n;
+		return true;
+	};
+
+	bool first = true;
+	auto const readFileHeader = [&](){
+		char magic[4];
+		uint32_t version;
+		int32_t k;
+		if (!read(magic, sizeof(magic)) || std::memcmp(magic, MAGIC, sizeof(magic)) != 0
+				|| !read(&version, sizeof(version)) || version != VERSION || !read(&k, sizeof(k))
+				|| k < ACTIVATIONS || k > REPAIRS || (!first && k != kind)){
+			munmap(const_cast<char*>(data), size);
+			throw std::invalid_argument("Not a binary extra_data file: " + filename);
+		}
+		kind = ExtraDataKind(k);
+		first = false;
+	};
+
+	readFileHeader();
+	while (position < size){
+		if (size - position >= sizeof(MAGIC) && std::memcmp(data + position, MAGIC, sizeof(MAGIC)) == 0){
+			readFileHeader(); // Of a file appended to this one
+			continue;
+		}
+		ExtraDataSection section;
+		int32_t header[4], layout[2];
+		if (!readString(section.problem) || !read(header, sizeof(header))
+				|| header[3] < 0 || std::size_t(header[3]) > (size - position) / sizeof(uint32_t))
+			break;
+		section.D = header[0];
+		section.NP = header[1];
+		section.interval = header[2];
+		section.configurations.resize(header[3]);
+		bool valid = true;
+		for (std::string& s : section.configurations)
+			valid = valid && readString(s);
+		if (!valid || !read(layout, sizeof(layout)))
+			break;
+		section.floating = layout[0];
+		section.columns = layout[1];
+		section.records = data + position;
+		section.count = 0;
+		section.complete = false;
+
+		std::size_t const width = sizeof(int32_t) + section.columns * (section.floating ? 8 : 4);
+		int32_t generation;
+		while (read(&generation, sizeof(generation))){
+			if (generation == SECTION_END){
+				section.complete = true;
+				break;
+			}
+			if (position - sizeof(generation) + width > size){
+				position = size; // Truncated record
+				break;
+			}
+			position += width - sizeof(generation);
+			section.count++;
+		}
+		sections.push_back(section);
+	}
+}
+
+ExtraDataReader::~ExtraDataReader(){
+	munmap(const_cast<char*>(data), size);
+}
+
+ExtraDataKind ExtraDataReader::getKind() const {
+	return kind;
+}
+
+std::vector<ExtraDataSection> const& ExtraDataReader::getSections() const {
+	return sections;
+}
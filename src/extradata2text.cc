@@ -0,0 +1,46 @@
+// Converts binary extra_data logs (--log-format BINARY) back to the text format: ./extradata2text <file.bin>...
+// writes each <file> next to its binary log.
+#include <iostream>
+#include <string>
+#include <vector>
+#include "extradata.h"
+#include "params.h"
+#include "default_params.h"
+
+static void convert(std::string const& filename){
+	std::string const suffix = ".bin";
+	if (filename.size() <= suffix.size() || filename.compare(filename.size() - suffix.size(), suffix.size(), suffix) != 0)
+		throw std::invalid_argument("Not a binary extra_data file: " + filename);
+
+	ExtraDataReader const reader(filename);
+	ExtraDataLog text(filename.substr(0, filename.size() - suffix.size()), reader.getKind(), false);
+	std::vector<double> doubles;
+	std::vector<int> ints;
+	for (ExtraDataSection const& section : reader.getSections()){
+		text.begin(section.problem, section.D, section.NP, section.interval, section.configurations);
+		doubles.resize(section.columns);
+		ints.resize(section.columns);
+		for (std::size_t r = 0; r < section.count; r++){
+			for (int c = 0; c < section.columns; c++){
+				doubles[c] = section.value(r, c);
+				ints[c] = doubles[c];
+			}
+			if (section.floating)
+				text.record(section.generation(r), doubles.data());
+			else
+				text.record(section.generation(r), ints.data());
+		}
+		if (section.complete)
+			text.end();
+	}
+}
+
+int main(int argc, char** argv){
+	if (argc < 2){
+		std::cerr << "Usage: " << argv[0] << " <file.bin>..." << std::endl;
+		return 1;
+	}
+	for (int i = 1; i < argc; i++)
+		convert(argv[i]);
+	return 0;
+}
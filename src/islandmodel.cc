@@ -0,0 +1,183 @@
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+#include "islandmodel.h"
+#include "params.h"
+#include "util.h"
+
+MigrationChannel::MigrationChannel(int const D, int const capacity)
+	:positions(D, capacity), fitness(capacity), mask(capacity-1), head(0), tail(0){
+	assert(capacity > 0 && (capacity & (capacity-1)) == 0);
+}
+
+bool MigrationChannel::push(ConstColumn const& x, double const f){
+	unsigned int const t = tail.load(std::memory_order_relaxed);
+	if (t - head.load(std::memory_order_acquire) > mask)
+		return false;
+	positions.col(t & mask) = x;
+	fitness(t & mask) = f;
+	tail.store(t+1, std::memory_order_release); // Publishes the slot to the consumer
+	return true;
+}
+
+bool MigrationChannel::pop(ArrayXd& x, double& f){
+	unsigned int const h = head.load(std::memory_order_relaxed);
+	if (h == tail.load(std::memory_order_acquire))
+		return false;
+	x = positions.col(h & mask);
+	f = fitness(h & mask);
+	head.store(h+1, std::memory_order_release); // Hands the slot back to the producer
+	return true;
+}
+
+IslandModel::IslandModel(std::string const id, DEConfig const config, int const islands, std::string const topology)
+	:id(id), topology(topology), problem(nullptr), evaluations(0), budget(0), targetHit(false){
+	if (topology != "RING" && topology != "STAR" && topology != "RANDOM")
+		throw std::invalid_argument("no such topology: " + topology);
+	// The first island logs to the extra_data files of the model itself. The islands split params::threads,
+	// each running on at least its own thread, so that the model does not start islands * threads threads.
+	for (int i = 0; i < islands; i++){
+		int const threads = std::max(1, params::threads / islands + (i < params::threads % islands));
+		this->islands.push_back(new DifferentialEvolution(i == 0 ? id : id + "-island" + std::to_string(i), config,
+			threads));
+		this->islands.back()->join(this, i);
+	}
+}
+
+IslandModel::~IslandModel(){
+	for (DifferentialEvolution* const island : islands)
+		delete island;
+	disconnect();
+}
+
+void IslandModel::connect(int const from, int const to, int const D){
+	int capacity = 1;
+	while (capacity < 2 * params::migration_size)
+		capacity *= 2;
+	channels.push_back(new MigrationChannel(D, capacity));
+	outgoing[from].push_back(channels.back());
+	incoming[to].push_back(channels.back());
+}
+
+void IslandModel::disconnect(){
+	for (MigrationChannel* const channel : channels)
+		delete channel;
+	channels.clear();
+	outgoing.clear();
+	incoming.clear();
+}
+
+// Runs all islands until the shared budget is spent or the final target is hit. An island that converges
+// restarts on its own, while the others carry on.
+void IslandModel::run(coco_problem_t* const problem, int const evalBudget, int const popSize){
+	int const M = islands.size();
+	int const D = coco_problem_get_dimension(problem);
+	this->problem = problem;
+	budget = evalBudget;
+	evaluations = coco_problem_get_evaluations(problem);
+	targetHit = coco_problem_final_target_hit(problem);
+
+	outgoing.assign(M, std::vector<MigrationChannel*>());
+	incoming.assign(M, std::vector<MigrationChannel*>());
+	for (int i = 0; i < M && M > 1; i++){
+		if (topology == "RING")
+			connect(i, (i+1) % M, D);
+		else if (topology == "STAR" && i > 0){
+			connect(0, i, D);
+			connect(i, 0, D);
+		} else if (topology == "RANDOM")
+			for (int j = 0; j < M; j++)
+				if (j != i)
+					connect(i, j, D);
+	}
+	received.assign(M, ArrayXd(D));
+
+	// The islands are prepared on the calling thread: it owns the COCO logger, which is initialized on the
+	// first evaluation. The other threads continue with streams seeded from the caller's.
+	std::string const engine = rng.getEngine();
+	std::vector<uint64_t> seeds;
+	for (int i = 0; i < M; i++){
+		islands[i]->prepare(problem, popSize);
+		seeds.push_back(rng.randWord());
+	}
+
+	auto const work = [this, problem, &engine, &seeds, evalBudget, popSize](int const i){
+		if (i > 0){
+			rng.setEngine(engine);
+			rng.seed(seeds[i]);
+		}
+		while (true){
+			islands[i]->run(evalBudget);
+			if (exhausted())
+				break;
+			islands[i]->reset();
+			islands[i]->prepare(problem, popSize);
+		}
+		islands[i]->reset();
+	};
+
+	std::vector<std::thread> threads;
+	for (int i = 1; i < M; i++)
+		threads.emplace_back(work, i);
+	work(0);
+	for (std::thread& thread : threads)
+		thread.join();
+
+	disconnect();
+}
+
+bool IslandModel::exhausted() const{
+	return targetHit || evaluations >= budget;
+}
+
+int IslandModel::reserve(int const n){
+	long reserved = evaluations.load();
+	long granted = 0;
+	do {
+		if (targetHit)
+			return 0;
+		granted = std::max(0L, std::min((long)n, budget - reserved));
+	} while (granted > 0 && !evaluations.compare_exchange_weak(reserved, reserved + granted));
+	return granted;
+}
+
+// Records the values an island computed on the observed problem
+void IslandModel::commit(Population const& population, std::vector<int> const& indices){
+	std::lock_guard<std::mutex> lock(mutex);
+	for (int const i : indices){
+		double f = population.getFitness(i);
+		coco_evaluate_function_given(problem, population.X(i).data(), &f);
+	}
+	if (coco_problem_final_target_hit(problem))
+		targetHit = true;
+}
+
+// Migrants replace the worst individuals they improve on; then the best individuals are sent out
+void IslandModel::migrate(int const island, Population& genomes){
+	ArrayXd& x = received[island];
+	double f;
+	for (MigrationChannel* const channel : incoming[island]){
+		while (channel->pop(x, f)){
+			int const worst = getWorst(genomes);
+			if (f < genomes.getFitness(worst)){
+				genomes.setX(worst, x);
+				genomes.setFitness(worst, f);
+			}
+		}
+	}
+
+	std::vector<MigrationChannel*> const& targets = outgoing[island];
+	if (targets.empty())
+		return;
+	std::vector<int> const sorted = sortOnFitness(genomes);
+	int const n = std::min(params::migration_size, genomes.size());
+	if (topology == "RANDOM"){
+		MigrationChannel* const channel = targets[rng.randInt(0, targets.size()-1)];
+		for (int k = 0; k < n; k++)
+			channel->push(genomes.X(sorted[k]), genomes.getFitness(sorted[k]));
+	} else {
+		for (MigrationChannel* const channel : targets)
+			for (int k = 0; k < n; k++)
+				channel->push(genomes.X(sorted[k]), genomes.getFitness(sorted[k]));
+	}
+}
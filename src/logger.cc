@@ -1,21 +1,306 @@
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
 #include <exception>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include "checkpoint.h"
 #include "logger.h"
+#include "params.h"
+
+// The background thread formatting the records of all active loggers. It drains them when a producer wakes it
+// (its ring is half full, blocked or flushed), and at least every few milliseconds.
+class LogWriter {
+	private:
+		std::mutex mutex; // Guards the loggers, held while draining so a logger never goes away mid-write
+		std::vector<Logger*> loggers;
+		std::mutex signal;
+		std::condition_variable woken;
+		bool pending = false, stopping = false;
+		std::thread thread;
+		void work();
+	public:
+		LogWriter() : thread(&LogWriter::work, this){}
+		~LogWriter();
+		static LogWriter& get();
+		void add(Logger* const logger);
+		void remove(Logger* const logger);
+		void drain(Logger* const logger); // On the calling thread
+		void wake();
+};
+
+LogWriter& LogWriter::get(){
+	static LogWriter writer;
+	return writer;
+}
+
+LogWriter::~LogWriter(){
+	{
+		std::lock_guard<std::mutex> lock(signal);
+		stopping = true;
+	}
+	woken.notify_one();
+	thread.join();
+}
+
+void LogWriter::work(){
+	while (true){
+		{
+			std::unique_lock<std::mutex> lock(signal);
+			woken.wait_for(lock, std::chrono::milliseconds(10), [this](){return pending || stopping;});
+			if (stopping)
+				return; // What is left is drained by the loggers, when they are flushed or destroyed
+			pending = false;
+		}
+		std::lock_guard<std::mutex> lock(mutex);
+		for (Logger* const logger : loggers)
+			logger->drain();
+	}
+}
+
+void LogWriter::add(Logger* const logger){
+	std::lock_guard<std::mutex> lock(mutex);
+	loggers.push_back(logger);
+}
+
+void LogWriter::remove(Logger* const logger){
+	std::lock_guard<std::mutex> lock(mutex);
+	loggers.erase(std::find(loggers.begin(), loggers.end(), logger));
+}
+
+void LogWriter::drain(Logger* const logger){
+	std::lock_guard<std::mutex> lock(mutex);
+	logger->drain();
+	logger->out.flush();
+}
+
+void LogWriter::wake(){
+	{
+		std::lock_guard<std::mutex> lock(signal);
+		pending = true;
+	}
+	woken.notify_one();
+}
+
+Logger::Logger(std::string filename)
+	:filename(filename), blocking(params::log_policy == "BLOCK"), head(0), tail(0){
+	if (params::log_policy != "BLOCK" && params::log_policy != "DROP")
+		throw std::invalid_argument("no such log policy: " + params::log_policy);
+}
 
 Logger::~Logger(){
-	if (activated)
+	if (activated){
+		flush();
+		LogWriter::get().remove(this);
 		out.close();
+		if (dropped > 0)
+			std::cerr << "Dropped " << dropped << " lines of " << filename << " on a full log buffer" << std::endl;
+	}
 };
 
 void Logger::flush(){
-	if (activated)
-		out.flush();
+	if (activated){
+		if (!dropping)
+			publish();
+		LogWriter::get().drain(this);
+	}
 }
 
 void Logger::checkActive(){
-	if (!activated){
-		out.open(filename);
-		if (!out.is_open())
-			throw std::invalid_argument("Failed to open file " + filename);
-		activated = true;
+	if (!activated)
+		open(std::ios::binary);
+}
+
+void Logger::open(std::ios::openmode const mode){
+	out.open(filename, mode);
+	if (!out.is_open())
+		throw std::invalid_argument("Failed to open file " + filename);
+	std::size_t capacity = 1024;
+	while (capacity < std::size_t(params::log_buffer) * 1024)
+		capacity *= 2;
+	ring.resize(capacity);
+	mask = capacity - 1;
+	activated = true;
+	LogWriter::get().add(this);
+}
+
+// A line in progress is not part of the checkpoint
+void Logger::save(Checkpoint& checkpoint){
+	int64_t size = -1; // The file is not open yet
+	if (activated){
+		LogWriter::get().drain(this);
+		size = out.tellp();
+	}
+	checkpoint.write(size);
+}
+
+// The logger must not have been written to. If the file was not open at the checkpoint, it is overwritten.
+void Logger::restore(Checkpoint& checkpoint){
+	int64_t size;
+	checkpoint.read(size);
+	if (size < 0)
+		return;
+	if (truncate(filename.c_str(), size) != 0)
+		throw std::invalid_argument("Failed to resume file " + filename);
+	open(std::ios::binary | std::ios::in | std::ios::out);
+	out.seekp(0, std::ios::end);
+}
+
+// Makes room for a record of size bytes in the line in progress. False if the line is dropped: the ring is
+// full under the DROP policy, or the line does not fit in it at all.
+bool Logger::reserve(std::size_t const size){
+	if (dropping)
+		return false;
+	if (end + size - tail.load(std::memory_order_relaxed) > ring.size()){
+		if (blocking || kept)
+			throw std::length_error("Line longer than the log buffer of " + filename);
+		dropping = true;
+		return false;
+	}
+	while (end + size - head.load(std::memory_order_acquire) > ring.size()){
+		if (!blocking && !kept){
+			dropping = true;
+			return false;
+		}
+		LogWriter::get().wake();
+		std::this_thread::yield();
+	}
+	return true;
+}
+
+void Logger::append(void const* data, std::size_t const size){
+	std::size_t const start = end & mask, first = std::min(size, ring.size() - start);
+	std::memcpy(&ring[start], data, first);
+	std::memcpy(&ring[0], static_cast<char const*>(data) + first, size - first);
+	end += size;
+}
+
+void Logger::read(std::size_t const position, void* data, std::size_t const size) const {
+	std::size_t const start = position & mask, first = std::min(size, ring.size() - start);
+	std::memcpy(data, &ring[start], first);
+	std::memcpy(static_cast<char*>(data) + first, &ring[0], size - first);
+}
+
+void Logger::record(char const* s, std::size_t const length){
+	Tag const tag = STRING;
+	uint32_t const n = length;
+	if (reserve(1 + sizeof(n) + n)){
+		append(&tag, 1);
+		append(&n, sizeof(n));
+		append(s, n);
+	}
+}
+
+// Publishes the line in progress to the writer, which is woken once the ring gets half full
+void Logger::publish(){
+	std::size_t const h = head.load(std::memory_order_relaxed), previous = tail.load(std::memory_order_relaxed);
+	tail.store(end, std::memory_order_release);
+	kept = false;
+	if (previous - h <= ring.size() / 2 && end - h > ring.size() / 2)
+		LogWriter::get().wake();
+}
+
+// Publishes the line in progress, or forgets it if it was dropped
+void Logger::finishLine(){
+	if (dropping){
+		dropping = false;
+		kept = false;
+		end = tail.load(std::memory_order_relaxed);
+		dropped++;
+	} else
+		publish();
+}
+
+void Logger::endLine(){
+	checkActive();
+	Tag const tag = NEWLINE;
+	if (reserve(1))
+		append(&tag, 1);
+	finishLine();
+}
+
+void Logger::write(void const* data, std::size_t const size, bool const end, bool const droppable){
+	checkActive();
+	Tag const tag = RAW;
+	uint32_t const n = size;
+	kept = kept || !droppable;
+	if (reserve(1 + sizeof(n) + n)){
+		append(&tag, 1);
+		append(&n, sizeof(n));
+		append(data, n);
+	}
+	if (end)
+		finishLine();
+}
+
+void Logger::drain(){
+	std::size_t position = head.load(std::memory_order_relaxed);
+	std::size_t const last = tail.load(std::memory_order_acquire);
+	std::string s;
+	while (position < last){
+		Tag tag;
+		read(position++, &tag, 1);
+		switch (tag){
+			case INT: {
+				int64_t value;
+				read(position, &value, sizeof(value));
+				position += sizeof(value);
+				out << value;
+				break;
+			}
+			case DOUBLE: {
+				double value;
+				read(position, &value, sizeof(value));
+				position += sizeof(value);
+				out << value;
+				break;
+			}
+			case STRING: {
+				uint32_t n;
+				read(position, &n, sizeof(n));
+				s.resize(n);
+				read(position + sizeof(n), &s[0], n);
+				position += sizeof(n) + n;
+				out << s;
+				break;
+			}
+			case INTS:
+			case DOUBLES: {
+				Eigen::IOFormat const* format;
+				uint32_t n;
+				read(position, &format, sizeof(format));
+				read(position + sizeof(format), &n, sizeof(n));
+				position += sizeof(format) + sizeof(n);
+				if (tag == INTS){
+					Eigen::Matrix<int64_t, 1, Eigen::Dynamic> v(n);
+					read(position, v.data(), n * sizeof(int64_t));
+					position += n * sizeof(int64_t);
+					out << v.format(*format);
+				} else {
+					Eigen::RowVectorXd v(n);
+					read(position, v.data(), n * sizeof(double));
+					position += n * sizeof(double);
+					out << v.format(*format);
+				}
+				break;
+			}
+			case NEWLINE:
+				out << "\n";
+				break;
+			case RAW: {
+				uint32_t n;
+				read(position, &n, sizeof(n));
+				s.resize(n);
+				read(position + sizeof(n), &s[0], n);
+				position += sizeof(n) + n;
+				out.write(s.data(), n);
+				break;
+			}
+		}
 	}
+	head.store(position, std::memory_order_release);
 }
@@ -24,246 +24,274 @@ std::function<MutationManager* (ConstraintHandler* const)> MutationManager::crea
 	throw std::invalid_argument("no such MutationManager: " + id);
 }
 
-Solution* MutationManager::mutate(std::vector<Solution*>const& genomes, int const i, double const F){
-	int resamples = 0;
-	while (true){
-		Solution* const m = doMutation(genomes, i, F);
-		if (!ch->resample(m, resamples)){
-			ch->repair(m); //generic repair
-			return m;
-		}
-		resamples++;
-		delete m;
-	}
-}
-
 // Rand/1
-Solution* Rand1MutationManager::doMutation(std::vector<Solution*>const& genomes, int const i, double const F) const{
-	std::vector<Solution*> const xr = pickRandom(remove(genomes,i), 3, false);
-	Solution* const m = new Solution(xr[0]->X() + F * (xr[1]->X() - xr[2]->X()));
-	ch->repair(m, xr[0], genomes[i]);
-	return m;
+void Rand1MutationManager::doMutation(Population const& genomes, int const i, double const F, Column donor) const{
+	std::array<int, 3> const xr = pickRandom<3>(genomes.size(), i);
+	donor = genomes.X(xr[0]) + F * (genomes.X(xr[1]) - genomes.X(xr[2]));
+	ch->repair(donor, genomes.X(xr[0]), genomes.X(i));
 }
 
 // Target-to-best/1
-void TTB1MutationManager::prepare(std::vector<Solution*>const& genomes){
+void TTB1MutationManager::prepare(Population const& genomes){
 	best = getBest(genomes);
 }
 
-Solution* TTB1MutationManager::doMutation(std::vector<Solution*>const& genomes, int const i, double const F) const{
-	std::vector<Solution*> const xr = pickRandom(remove(genomes,i), 2, false);
-	Solution* const m = new Solution(
-			genomes[i]->X() + F * (best->X() - genomes[i]->X() + xr[0]->X() - xr[1]->X())
-		);
-	ch->repair(m, genomes[i], genomes[i]);
-	return m;
+void TTB1MutationManager::doMutation(Population const& genomes, int const i, double const F, Column donor) const{
+	std::array<int, 2> const xr = pickRandom<2>(genomes.size(), i);
+	donor = genomes.X(i) + F * (genomes.X(best) - genomes.X(i) + genomes.X(xr[0]) - genomes.X(xr[1]));
+	ch->repair(donor, genomes.X(i), genomes.X(i));
 }
 
 // Target-to-rand/1
-Solution* TTR1MutationManager::doMutation(std::vector<Solution*>const& genomes, int const i, double const F) const{
-	std::vector<Solution*> const xr = pickRandom(remove(genomes,i), 3, false);
-	Solution* const m = new Solution(
-			genomes[i]->X() + F * (xr[0]->X() - genomes[i]->X() + xr[1]->X() - xr[2]->X())
-		);
-	ch->repair(m, genomes[i], genomes[i]);
-	return m;
+void TTR1MutationManager::doMutation(Population const& genomes, int const i, double const F, Column donor) const{
+	std::array<int, 3> const xr = pickRandom<3>(genomes.size(), i);
+	donor = genomes.X(i) + F * (genomes.X(xr[0]) - genomes.X(i) + genomes.X(xr[1]) - genomes.X(xr[2]));
+	ch->repair(donor, genomes.X(i), genomes.X(i));
 }
 
 // Target-to-best/2
-void TTB2MutationManager::prepare(std::vector<Solution*>const& genomes){
+void TTB2MutationManager::prepare(Population const& genomes){
 	best = getBest(genomes);
 }
 
-Solution* TTB2MutationManager::doMutation(std::vector<Solution*>const& genomes, int const i, double const F) const{
-	std::vector<Solution*> const xr = pickRandom(remove(genomes,i), 4, false);
-	Solution* const m = new Solution(
-			genomes[i]->X() + F * (best->X() - genomes[i]->X() + xr[0]->X() 
-				- xr[1]->X() + xr[2]->X() - xr[3]->X())
-		);
-	ch->repair(m, genomes[i], genomes[i]);
-	return m;
+void TTB2MutationManager::doMutation(Population const& genomes, int const i, double const F, Column donor) const{
+	std::array<int, 4> const xr = pickRandom<4>(genomes.size(), i);
+	donor = genomes.X(i) + F * (genomes.X(best) - genomes.X(i) + genomes.X(xr[0]) 
+				- genomes.X(xr[1]) + genomes.X(xr[2]) - genomes.X(xr[3]));
+	ch->repair(donor, genomes.X(i), genomes.X(i));
 }
 
-void TTPB1MutationManager::prepare(std::vector<Solution*>const& genomes){
-	sorted = sortOnFitness(genomes);
+void TTPB1MutationManager::prepare(Population const& genomes){
+	sortOnFitness(genomes, sorted);
 }
 
 // Target-to-pbest/1
-Solution* TTPB1MutationManager::doMutation(std::vector<Solution*>const& genomes, int const i, double const F) const{
-	Solution const* const pBest = sorted[params::SHADE_p(genomes.size())];
-	std::vector<Solution*> const xr = pickRandom(remove(genomes,i), 2, false);
-	Solution* const m = new Solution(
-			genomes[i]->X() + F * (pBest->X() - genomes[i]->X() + xr[0]->X() - xr[1]->X())
-		);
-	ch->repair(m, genomes[i], genomes[i]);
-	return m;
+void TTPB1MutationManager::doMutation(Population const& genomes, int const i, double const F, Column donor) const{
+	int const pBest = sorted[params::SHADE_p(genomes.size())];
+	std::array<int, 2> const xr = pickRandom<2>(genomes.size(), i);
+	donor = genomes.X(i) + F * (genomes.X(pBest) - genomes.X(i) + genomes.X(xr[0]) - genomes.X(xr[1]));
+	ch->repair(donor, genomes.X(i), genomes.X(i));
 }
 
 // Best/1
-void Best1MutationManager::prepare(std::vector<Solution*>const& genomes){
+void Best1MutationManager::prepare(Population const& genomes){
 	best = getBest(genomes);
 }
 
-Solution* Best1MutationManager::doMutation(std::vector<Solution*>const& genomes, int const i, double const F) const{
-	std::vector<Solution*> const xr = pickRandom(remove(genomes,i), 2, false);
-	Solution* const m = new Solution(best->X() + F * (xr[0]->X() - xr[1]->X()));
-	ch->repair(m, best, genomes[i]);
-	return m;
+void Best1MutationManager::doMutation(Population const& genomes, int const i, double const F, Column donor) const{
+	std::array<int, 2> const xr = pickRandom<2>(genomes.size(), i);
+	donor = genomes.X(best) + F * (genomes.X(xr[0]) - genomes.X(xr[1]));
+	ch->repair(donor, genomes.X(best), genomes.X(i));
 }
 
 // Best/2
-void Best2MutationManager::prepare(std::vector<Solution*>const& genomes){
+void Best2MutationManager::prepare(Population const& genomes){
 	best = getBest(genomes);
 }
 
-Solution* Best2MutationManager::doMutation(std::vector<Solution*>const& genomes, int const i, double const F) const{
-	std::vector<Solution*> const xr = pickRandom(remove(genomes,i), 4, false);
-	Solution* const m = new Solution(best->X() + F * (xr[0]->X() - xr[1]->X() + xr[2]->X() - xr[3]->X()));
-	ch->repair(m, best, genomes[i]);
-	return m;
+void Best2MutationManager::doMutation(Population const& genomes, int const i, double const F, Column donor) const{
+	std::array<int, 4> const xr = pickRandom<4>(genomes.size(), i);
+	donor = genomes.X(best) + F * (genomes.X(xr[0]) - genomes.X(xr[1]) 
+				+ genomes.X(xr[2]) - genomes.X(xr[3]));
+	ch->repair(donor, genomes.X(best), genomes.X(i));
 }
 
 // Rand/2
-Solution* Rand2MutationManager::doMutation(std::vector<Solution*>const& genomes, int const i, double const F) const{
-	std::vector<Solution*> const xr = pickRandom(remove(genomes,i), 5, false);
-	Solution* const m = new Solution(xr[0]->X() + F * (xr[1]->X() - xr[2]->X() + xr[3]->X() - xr[4]->X()));
-	ch->repair(m, xr[0], genomes[i]);
-	return m;
+void Rand2MutationManager::doMutation(Population const& genomes, int const i, double const F, Column donor) const{
+	std::array<int, 5> const xr = pickRandom<5>(genomes.size(), i);
+	donor = genomes.X(xr[0]) + F * (genomes.X(xr[1]) - genomes.X(xr[2]) 
+				+ genomes.X(xr[3]) - genomes.X(xr[4]));
+	ch->repair(donor, genomes.X(xr[0]), genomes.X(i));
 }
 
 // Rand/2/dir
-Solution* Rand2DirMutationManager::doMutation(std::vector<Solution*>const& genomes, int const i, double const F) const{
-	std::vector<Solution*> xr = pickRandom(remove(genomes,i), 4, false);
+void Rand2DirMutationManager::doMutation(Population const& genomes, int const i, double const F, Column donor) const{
+	std::array<int, 4> xr = pickRandom<4>(genomes.size(), i);
 
-	if (xr[1]->getFitness() < xr[0]->getFitness())
+	if (genomes.getFitness(xr[1]) < genomes.getFitness(xr[0]))
 		std::swap(xr[0], xr[1]);
 
-	if (xr[3]->getFitness() < xr[2]->getFitness())
+	if (genomes.getFitness(xr[3]) < genomes.getFitness(xr[2]))
 		std::swap(xr[2], xr[3]);
 
-	Solution* m = new Solution(xr[0]->X() + F/2. * (xr[0]->X() - xr[1]->X() + xr[2]->X() - xr[3]->X()));
-	ch->repair(m, xr[0], genomes[i]);
-	return m;
+	donor = genomes.X(xr[0]) + F/2. * (genomes.X(xr[0]) - genomes.X(xr[1]) 
+				+ genomes.X(xr[2]) - genomes.X(xr[3]));
+	ch->repair(donor, genomes.X(xr[0]), genomes.X(i));
 }
 
 // NSDE
-Solution* NSDEMutationManager::doMutation(std::vector<Solution*>const& genomes, int const i, double const /*F*/) const {
-	std::vector<Solution*> const xr = pickRandom(remove(genomes,i), 3, false);
+void NSDEMutationManager::doMutation(Population const& genomes, int const i, double const /*F*/, Column donor) const{
+	std::array<int, 3> const xr = pickRandom<3>(genomes.size(), i);
 	double const F = (rng.randDouble(0,1) <= .5 ? rng.normalDouble(.5,.5) : rng.cauchyDouble(0,1));
-	Solution* const m = new Solution(xr[0]->X() + F * (xr[1]->X() - xr[2]->X()));
-	ch->repair(m, xr[0], genomes[i]);
-	return m;
+	donor = genomes.X(xr[0]) + F * (genomes.X(xr[1]) - genomes.X(xr[2]));
+	ch->repair(donor, genomes.X(xr[0]), genomes.X(i));
 }
 
 // Trigonometric
-Solution* TrigonometricMutationManager::doMutation(std::vector<Solution*>const& genomes, int const i, double const F) const{
-	return rng.randDouble(0,1) <= gamma ? trigonometricMutation(genomes, i, F) : rand1Mutation(genomes, i, F);
+void TrigonometricMutationManager::prepare(Population const& genomes){
+	base.resize(genomes.dimension());
 }
 
-Solution* TrigonometricMutationManager::trigonometricMutation(std::vector<Solution*>const& genomes, int const i, 
-		double const /*F*/) const{
-	std::vector<Solution*> const xr = pickRandom(remove(genomes,i), 3, false);
+void TrigonometricMutationManager::doMutation(Population const& genomes, int const i, double const F, Column donor) const{
+	if (rng.randDouble(0,1) <= gamma)
+		trigonometricMutation(genomes, i, F, donor);
+	else
+		rand1Mutation(genomes, i, F, donor);
+}
+
+void TrigonometricMutationManager::trigonometricMutation(Population const& genomes, int const i, 
+		double const /*F*/, Column donor) const{
+	std::array<int, 3> const xr = pickRandom<3>(genomes.size(), i);
 
-	double const pPrime = std::abs(xr[0]->getFitness()) + std::abs(xr[1]->getFitness()) + std::abs(xr[2]->getFitness());
-	double const p0 = std::abs(xr[0]->getFitness()) / pPrime;
-	double const p1 = std::abs(xr[1]->getFitness()) / pPrime;
-	double const p2 = std::abs(xr[2]->getFitness()) / pPrime;
+	double const pPrime = std::abs(genomes.getFitness(xr[0])) + std::abs(genomes.getFitness(xr[1])) 
+		+ std::abs(genomes.getFitness(xr[2]));
+	double const p0 = std::abs(genomes.getFitness(xr[0])) / pPrime;
+	double const p1 = std::abs(genomes.getFitness(xr[1])) / pPrime;
+	double const p2 = std::abs(genomes.getFitness(xr[2])) / pPrime;
 
-	ArrayXd mutant = (xr[0]->X() + xr[1]->X() + xr[2]->X())/3.;
-	Solution const base = Solution(mutant); // only used for correction strategies
+	base = (genomes.X(xr[0]) + genomes.X(xr[1]) + genomes.X(xr[2]))/3.; // only used for correction strategies
 
-	mutant += (p1-p0) * (xr[0]->X() - xr[1]->X()) + (p2-p1) * (xr[1]->X() - xr[2]->X()) + 
-		(p0-p2) * (xr[2]->X() - xr[0]->X());
-	
-	Solution* m = new Solution(mutant);
-	ch->repair(m, &base, genomes[i]);
-	return m;
+	donor = base + ((p1-p0) * (genomes.X(xr[0]) - genomes.X(xr[1])) 
+			+ (p2-p1) * (genomes.X(xr[1]) - genomes.X(xr[2])) + (p0-p2) * (genomes.X(xr[2]) - genomes.X(xr[0])));
+	ch->repair(donor, base, genomes.X(i));
 }
 
-Solution* TrigonometricMutationManager::rand1Mutation(std::vector<Solution*>const& genomes, int const i, double const F) const{
-	std::vector<Solution*> const xr = pickRandom(remove(genomes,i), 3, false);
-	ArrayXd const mutant = xr[0]->X() + F * (xr[1]->X() - xr[2]->X());
-	Solution* const m = new Solution(mutant);
-	ch->repair(m, xr[0], genomes[i]);
-	return m;
+void TrigonometricMutationManager::rand1Mutation(Population const& genomes, int const i, double const F, Column donor) const{
+	std::array<int, 3> const xr = pickRandom<3>(genomes.size(), i);
+	donor = genomes.X(xr[0]) + F * (genomes.X(xr[1]) - genomes.X(xr[2]));
+	ch->repair(donor, genomes.X(xr[0]), genomes.X(i));
 }
 
 // Two-opt/1
-Solution* TwoOpt1MutationManager::doMutation(std::vector<Solution*>const& genomes, int const i, double const F) const{
-	std::vector<Solution*> xr = pickRandom(remove(genomes,i), 3, false);
-	if (xr[1]->getFitness() < xr[0]->getFitness())
+void TwoOpt1MutationManager::doMutation(Population const& genomes, int const i, double const F, Column donor) const{
+	std::array<int, 3> xr = pickRandom<3>(genomes.size(), i);
+	if (genomes.getFitness(xr[1]) < genomes.getFitness(xr[0]))
 		std::swap(xr[0], xr[1]);
-	Solution* const m = new Solution(xr[0]->X() + F * (xr[1]->X() - xr[2]->X()));
-	ch->repair(m, xr[0], genomes[i]);
-	return m;
+	donor = genomes.X(xr[0]) + F * (genomes.X(xr[1]) - genomes.X(xr[2]));
+	ch->repair(donor, genomes.X(xr[0]), genomes.X(i));
 }
 
 // Two-opt/2
-Solution* TwoOpt2MutationManager::doMutation(std::vector<Solution*>const& genomes, int const i, double const F) const{
-	std::vector<Solution*> xr = pickRandom(remove(genomes,i), 5, false);
-	if (xr[1]->getFitness() < xr[0]->getFitness())
+void TwoOpt2MutationManager::doMutation(Population const& genomes, int const i, double const F, Column donor) const{
+	std::array<int, 5> xr = pickRandom<5>(genomes.size(), i);
+	if (genomes.getFitness(xr[1]) < genomes.getFitness(xr[0]))
 		std::swap(xr[0], xr[1]);
-	Solution* const m = new Solution(xr[0]->X() + F * (xr[1]->X() - xr[2]->X() + xr[3]->X() - xr[4]->X()));
-	ch->repair(m, xr[0], genomes[i]);
-	return m;
+	donor = genomes.X(xr[0]) + F * (genomes.X(xr[1]) - genomes.X(xr[2]) 
+				+ genomes.X(xr[3]) - genomes.X(xr[4]));
+	ch->repair(donor, genomes.X(xr[0]), genomes.X(i));
 }
 
 // Proximity-based Rand/1
-void ProximityMutationManager::prepare(std::vector<Solution*>const& genomes){
-	int const size = genomes.size();
-	//Initialize the matrices
-	ArrayXXd Rd(size, size);
-	Rd.matrix().diagonal().fill(0.);
+void ProximityMutationManager::prepare(Population const& genomes){
+	ArrayXXd const& X = genomes.X();
+	int const size = X.cols();
+
+	replaced.clear();
+	if (positions.rows() == X.rows() && positions.cols() == size){
+		for (int j = 0; j < size; j++)
+			if ((X.col(j) != positions.col(j)).any())
+				replaced.push_back(j);
+	}
 
-	// Fill distance matrix
-	for (int i = 0; i < size-1; i++){ // Only fill upper triangle
-		for (int j = i+1; j < size; j++){
-			double const dist = std::max(distance(genomes[i], genomes[j]), 1.0e-10);
-			Rd(i,j) = Rd(j,i) = dist;
-		}
+	// Updating c columns costs O(c*NP*D), against O(NP^2*D) for the full product
+	if (Rd.cols() != size || replaced.size() > size/2u){
+		positions = X;
+		computeDistances();
+	} else if (!replaced.empty()){
+		for (int const j : replaced)
+			positions.col(j) = X.col(j);
+		updateDistances();
 	}
 
-	Rp = (Rd.colwise() / Rd.rowwise().sum()).cwiseInverse();
+	// Rd is symmetric, so its column sums equal the row sums
+	sums = Rd.colwise().sum().transpose();
+	Rp = (Rd.rowwise() / sums.transpose()).cwiseInverse();
 	Rp.matrix().diagonal().fill(0.);
 }
 
-Solution* ProximityMutationManager::doMutation(std::vector<Solution*>const& genomes, int const i, double const F) const{
-	std::vector<double> prob(Rp.row(i).begin(), Rp.row(i).end());
-	std::vector<Solution*> const xr = rouletteSelect(remove(genomes, i), remove(prob, i), 3, false);
-	Solution* const m = new Solution(xr[0]->X() + F * (xr[1]->X() - xr[2]->X()));
-	ch->repair(m, xr[0], genomes[i]);
-	return m;
+// All pairwise distances through the Gram identity |a-b|^2 = |a|^2 + |b|^2 - 2a.b, as one matrix product
+void ProximityMutationManager::computeDistances(){
+	int const size = positions.cols();
+	center = positions.rowwise().mean();
+	centered = (positions.colwise() - center).matrix();
+	squaredNorms = centered.colwise().squaredNorm().transpose();
+	gram.noalias() = centered.transpose() * centered;
+
+	Rd = ((-2. * gram.array()).colwise() + squaredNorms).rowwise() + squaredNorms.transpose();
+	Rd = Rd.max(0.).sqrt().max(1.0e-10);
+	Rd.matrix().diagonal().fill(0.);
+	assert(Rd.cols() == size);
+}
+
+// The Gram identity cancels catastrophically when the individuals are much closer to each other than to the
+// center: the rounding error of |a|^2 + |b|^2 - 2a.b grows with the norms, not with the distance. The center is
+// the population mean of the last full computation, which a converging population moves away from. Since the
+// mean squared norm is the squared spread of the population plus the squared distance of its mean to the center,
+// the population is off center when the spread accounts for less than a quarter of it.
+bool ProximityMutationManager::offCenter() const{
+	double const meanSquaredNorm = squaredNorms.mean();
+	double const spread = meanSquaredNorm - centered.rowwise().mean().squaredNorm();
+	return spread < meanSquaredNorm / 4.;
+}
+
+// Only recompute the rows and columns of the individuals that were replaced since the last call, unless the
+// population has moved off center, in which case all distances are recomputed around its current mean
+void ProximityMutationManager::updateDistances(){
+	int const c = replaced.size();
+	for (int const j : replaced){
+		centered.col(j) = (positions.col(j) - center).matrix();
+		squaredNorms(j) = centered.col(j).squaredNorm();
+	}
+	if (offCenter()){
+		computeDistances();
+		return;
+	}
+
+	changed.resize(centered.rows(), centered.cols()); // Sized for any number of replaced columns
+	for (int k = 0; k < c; k++)
+		changed.col(k) = centered.col(replaced[k]);
+	gram.leftCols(c).noalias() = centered.transpose() * changed.leftCols(c);
+
+	for (int k = 0; k < c; k++){
+		int const j = replaced[k];
+		Rd.col(j) = (squaredNorms + squaredNorms(j) - 2. * gram.col(k).array()).max(0.).sqrt().max(1.0e-10);
+		Rd.row(j) = Rd.col(j).transpose();
+		Rd(j,j) = 0.;
+	}
+}
+
+void ProximityMutationManager::doMutation(Population const& genomes, int const i, double const F, Column donor) const{
+	sampler.build(Rp.col(i)); // Rp(i,i) = 0, so i itself is never picked
+	std::array<int, 3> const xr = {sampler.next(), sampler.next(), sampler.next()};
+	donor = genomes.X(xr[0]) + F * (genomes.X(xr[1]) - genomes.X(xr[2]));
+	ch->repair(donor, genomes.X(xr[0]), genomes.X(i));
 }
 
 // Ranking based
-void RankingMutationManager::prepare(std::vector<Solution*>const& genomes){
+void RankingMutationManager::prepare(Population const& genomes){
 	int const size = genomes.size();
-	probability.clear();
-	sorted = sortOnFitness(genomes);
+	probability.resize(size);
+	sortOnFitness(genomes, sorted);
 	for (int i = 0; i < size; i++)
-		probability[sorted[i]] = double(size - (i+1)) / double(size);
+		probability(sorted[i]) = double(size - (i+1)) / double(size);
 }
 
-Solution* RankingMutationManager::pickRanked(std::vector<Solution*>& possibilities) const{
+int RankingMutationManager::pickRanked(IndexSampler& sampler) const{
 	int index;
 	do {
-		index = rng.randInt(0, possibilities.size()-1);
-	} while (rng.randDouble(0,1) > probability.at(possibilities[index]));
+		index = sampler.nth(rng.randInt(0, sampler.remaining()-1));
+	} while (rng.randDouble(0,1) > probability(index));
 
-	Solution* const pick = possibilities[index];
-	possibilities.erase(possibilities.begin() + index);
-	return pick;
+	sampler.exclude(index);
+	return index;
 }
 
-Solution* RankingMutationManager::doMutation(std::vector<Solution*>const& genomes, int const i, double const F) const{
-	Solution const* const pBest = sorted[params::SHADE_p(genomes.size())];
-	std::vector<Solution*> possibilities = remove(genomes,i);
-	Solution const* const xr0 = pickRanked(possibilities); // N.B. Ranked instead of Random (removes from possibilities)
-	Solution const* const xr1 = pickRandom(possibilities, 1, false)[0];
-
-	Solution* const m = new Solution(
-			genomes[i]->X() + F * (pBest->X() - genomes[i]->X() + xr0->X() - xr1->X())
-		);
-	ch->repair(m, genomes[i], genomes[i]);
-	return m;
+void RankingMutationManager::doMutation(Population const& genomes, int const i, double const F, Column donor) const{
+	int const pBest = sorted[params::SHADE_p(genomes.size())];
+	IndexSampler sampler(genomes.size(), i);
+	int const xr0 = pickRanked(sampler); // N.B. Ranked instead of Random (excludes the pick from the sampler)
+	int const xr1 = sampler.next();
+
+	donor = genomes.X(i) + F * (genomes.X(pBest) - genomes.X(i) + genomes.X(xr0) - genomes.X(xr1));
+	ch->repair(donor, genomes.X(i), genomes.X(i));
 }
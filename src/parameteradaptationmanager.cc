@@ -3,6 +3,7 @@
 #include <stdexcept>
 #include "parameteradaptationmanager.h"
 #include "rng.h"
+#include "checkpoint.h"
 
 std::function<ParameterAdaptationManager*(int const, int const)> ParameterAdaptationManager::create(std::string const id){
 #define ALIAS(X,Y) if(id==X) return [](int const popSize, int const K){return new Y(popSize, K);};
@@ -24,54 +25,63 @@ SHADEManager::SHADEManager(int const popSize, int const K) :
 	MF.fill(.5);
 }
 
-double SHADEManager::weightedMean(ArrayXd const& x, ArrayXd const& w) const{
+double SHADEManager::weightedMean(ConstColumn const& x, ConstColumn const& w) const{
 	return (w * x).sum();
 }
 
-double SHADEManager::weightedLehmerMean(ArrayXd const& x, ArrayXd const& w) const{
+double SHADEManager::weightedLehmerMean(ConstColumn const& x, ConstColumn const& w) const{
 	return (w * x.pow(2)).sum() / (w * x).sum();
 }
 
-ArrayXd SHADEManager::w(ArrayXd const& improvements) const {
-	return improvements/improvements.sum();
-}
-
 void SHADEManager::update(ArrayXd const& improvement){
-	std::vector<std::vector<double>> SF(K), SCr(K), improvements(K);
+	update(improvement, previousFs, previousCrs, previousAssignment);
+}
 
-	for (int i = 0; i < popSize; i++){
-		if (improvement(i) > 0.){
-			int const c = previousAssignment(i);
-			SF[c].push_back(previousFs(i)); 
-			SCr[c].push_back(previousCrs(i));
-			improvements[c].push_back(improvement(i));
-		}
+void SHADEManager::update(ArrayXd const& improvement, ArrayXd const& Fs, ArrayXd const& Crs, 
+		ArrayXi const& assignment){
+	successes.build(K, assignment, improvement.size(), [&improvement](int const i){return improvement(i) > 0.;});
+	if (SF.size() < improvement.size()){
+		SF.resize(improvement.size());
+		SCr.resize(improvement.size());
+		improvements.resize(improvement.size());
 	}
-	
+
 	for (int c = 0; c < K; c++){
-		if (!improvements[c].empty()){
-			ArrayXd const _w = w(ArrayXd::Map(improvements[c].data(), improvements[c].size()));
-			MF(c,k(c)) = weightedLehmerMean(ArrayXd::Map(SF[c].data(), SF[c].size()), _w);
-			MCr(c,k(c)) = weightedMean(ArrayXd::Map(SCr[c].data(), SCr[c].size()), _w);
+		Indices const successful = successes[c];
+		int const n = successful.size();
+		if (n > 0){
+			for (int j = 0; j < n; j++){
+				int const i = successful[j];
+				SF(j) = Fs(i);
+				SCr(j) = Crs(i);
+				improvements(j) = improvement(i);
+			}
+			improvements.head(n) /= improvements.head(n).sum(); // The weights
+			MF(c,k(c)) = weightedLehmerMean(SF.head(n), improvements.head(n));
+			MCr(c,k(c)) = weightedMean(SCr.head(n), improvements.head(n));
 			k(c) = (k(c)+1)%H;
 		}
 	}
 }
 
 void SHADEManager::nextParameters(ArrayXd& Fs, ArrayXd& Crs, ArrayXi const& assignment){
+	// Bulk draws around 0, shifted to the memory entry of each individual below
+	rng.fillCauchy(Fs, 0., .1);
+	rng.fillNormal(Crs, 0., .1);
+
 	for (int i = 0; i < popSize; i++){
 		int const randIndex = rng.randInt(0, H-1);
 		int const config = assignment(i); // The configuration that this individual will use
 
 		// Update mutation rate
 		double const MFr = MF(config, randIndex);
-		do{
+		Fs(i) = std::min(MFr + Fs(i), 1.);
+		while (Fs(i) <= 0.)
 			Fs(i) = std::min(rng.cauchyDouble(MFr, .1), 1.);
-		} while (Fs(i) <= 0.);
 
 		// Update crossover rate
 		double const MCrr = MCr(config, randIndex);
-		Crs[i] = std::max(std::min(rng.normalDouble(MCrr, .1),1.), 0.);
+		Crs[i] = std::max(std::min(MCrr + Crs[i], 1.), 0.);
 	}
 
 	previousFs = Fs;
@@ -79,6 +89,27 @@ void SHADEManager::nextParameters(ArrayXd& Fs, ArrayXd& Crs, ArrayXi const& assi
 	previousAssignment = assignment;
 }
 
+void SHADEManager::nextParameters(int const config, double& F, double& Cr){
+	int const randIndex = rng.randInt(0, H-1);
+	double const MFr = MF(config, randIndex);
+	do 
+		F = std::min(rng.cauchyDouble(MFr, .1), 1.);
+	while (F <= 0.);
+	Cr = std::max(std::min(rng.normalDouble(MCr(config, randIndex), .1), 1.), 0.);
+}
+
+void SHADEManager::save(Checkpoint& checkpoint) const{
+	checkpoint.write(MF);
+	checkpoint.write(MCr);
+	checkpoint.write(k);
+}
+
+void SHADEManager::restore(Checkpoint& checkpoint){
+	checkpoint.read(MF);
+	checkpoint.read(MCr);
+	checkpoint.read(k);
+}
+
 //NO ADAPTATION
 ConstantParameterManager::ConstantParameterManager(int const popSize, int const K)
  : ParameterAdaptationManager(popSize, K){}
@@ -87,6 +118,16 @@ void ConstantParameterManager::update(ArrayXd const& /*trials*/){
 	//ignore
 }
 
+void ConstantParameterManager::update(ArrayXd const& /*improvement*/, ArrayXd const& /*Fs*/, 
+		ArrayXd const& /*Crs*/, ArrayXi const& /*assignment*/){
+	//ignore
+}
+
+void ConstantParameterManager::nextParameters(int const /*config*/, double& F, double& Cr){
+	F = this->F;
+	Cr = this->Cr;
+}
+
 void ConstantParameterManager::nextParameters(ArrayXd& Fs, ArrayXd& Crs, 
 		ArrayXi const& /*assignment*/){
 	Fs.fill(F);
@@ -0,0 +1,128 @@
+#include "population.h"
+#include "rng.h"
+#include "checkpoint.h"
+
+Population::Population(int const D, int const size){
+	resize(D, size);
+}
+
+void Population::resize(int const D, int const size){
+	x.resize(D, size);
+	fitness = ArrayXd::Constant(size, std::numeric_limits<double>::max());
+	evaluated.assign(size, false);
+}
+
+int Population::size() const {
+	return x.cols();
+}
+
+int Population::dimension() const {
+	return x.rows();
+}
+
+ArrayXXd const& Population::X() const {
+	return x;
+}
+
+ArrayXXd::ConstColXpr Population::X(int const i) const {
+	return x.col(i);
+}
+
+ArrayXXd::ColXpr Population::modifyX(int const i){
+	evaluated[i] = false;
+	return x.col(i);
+}
+
+void Population::setX(int const i, ConstColumn const& x){
+	this->x.col(i) = x;
+	evaluated[i] = false;
+}
+
+ArrayXd const& Population::getFitness() const {
+	return fitness;
+}
+
+double Population::getFitness(int const i) const {
+	return fitness(i);
+}
+
+void Population::setFitness(int const i, double const f){
+	fitness(i) = f;
+	evaluated[i] = true;
+}
+
+bool Population::isEvaluated(int const i) const {
+	return evaluated[i];
+}
+
+double Population::evaluate(int const i, coco_problem_t* const problem){
+	if (!evaluated[i]){
+		evaluated[i] = true;
+		coco_evaluate_function(problem, x.col(i).data(), &fitness(i));
+	}
+	return fitness(i);
+}
+
+void Population::evaluate(coco_problem_t* const problem){
+	int const n = size();
+	for (int i = 0; i < n; i++){
+		if (evaluated[i])
+			continue;
+		int end = i;
+		while (end < n && !evaluated[end])
+			evaluated[end++] = true;
+		coco_evaluate_function_batch(problem, x.col(i).data(), end-i, &fitness(i));
+		i = end;
+	}
+}
+
+void Population::compute(coco_problem_t* const problem){
+	int const n = size();
+	for (int i = 0; i < n; i++){
+		if (evaluated[i])
+			continue;
+		int end = i;
+		while (end < n && !evaluated[end])
+			evaluated[end++] = true;
+		coco_compute_function_batch(problem, x.col(i).data(), end-i, &fitness(i));
+		i = end;
+	}
+}
+
+void Population::commit(int const i, coco_problem_t* const problem, double const f){
+	evaluated[i] = true;
+	fitness(i) = f;
+	coco_evaluate_function_given(problem, x.col(i).data(), &fitness(i));
+}
+
+void Population::randomize(int const i, ArrayXd const& lowerBounds, ArrayXd const& upperBounds){
+	rng.fillUniform(x.col(i), 0, 1);
+	x.col(i) = lowerBounds + x.col(i) * (upperBounds - lowerBounds);
+	evaluated[i] = false;
+}
+
+void Population::swap(int const i, Population& other){
+	x.col(i).swap(other.x.col(i));
+	std::swap(fitness(i), other.fitness(i));
+	bool const e = evaluated[i];
+	evaluated[i] = other.evaluated[i];
+	other.evaluated[i] = e;
+}
+
+void Population::save(Checkpoint& checkpoint) const{
+	checkpoint.write(x);
+	checkpoint.write(fitness);
+	for (bool const e : evaluated)
+		checkpoint.write(e);
+}
+
+void Population::restore(Checkpoint& checkpoint){
+	checkpoint.read(x);
+	checkpoint.read(fitness);
+	evaluated.resize(x.cols());
+	for (std::size_t i = 0; i < evaluated.size(); i++){
+		bool e;
+		checkpoint.read(e);
+		evaluated[i] = e;
+	}
+}
@@ -14,7 +14,7 @@ std::function<ProbabilityManager* (int const)> ProbabilityManager::create(std::s
 
 void AdaptivePursuitManager::updateProbability(ArrayXd& p, ArrayXd const& q) const {
 	Eigen::Index bestIdx; q.maxCoeff(&bestIdx);
-	ArrayXd const new_p = 
+	auto const new_p = 
 		ArrayXd::NullaryExpr(K, [this, bestIdx](Eigen::Index const i){return i == bestIdx ? pMax : pMin;});
 	p += beta * (new_p - p); // small beta -> slow change
 }
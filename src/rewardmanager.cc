@@ -16,74 +16,87 @@ std::function<RewardManager*(int const)> RewardManager::create(std::string const
 
 RewardManager::RewardManager(int const K): K(K){}
 
-std::vector<std::vector<double>> RewardManager::group(ArrayXd const& credits, 
-		ArrayXi const& assignment) const{
-	std::vector<std::vector<double>> groups(K);
-	for (unsigned int i = 0; i < credits.size(); i++){
-		if (credits(i) > 0.)
-			groups[assignment(i)].push_back(credits(i));
-	}
+// Groups the positive credits by the configuration that earned them
+Buckets const& RewardManager::group(ArrayXd const& credits, ArrayXi const& assignment){
+	groups.build(K, assignment, credits.size(), [&credits](int const i){return credits(i) > 0.;});
 	return groups;
 }
 
-ArrayXd RewardManager::average(std::vector<std::vector<double>>const& credits) const {
-	return ArrayXd::NullaryExpr(K, [credits](Eigen::Index const i){
-			return credits[i].empty() ? 0. : ArrayXd::Map(credits[i].data(), credits[i].size()).mean();
-		});
+// The credits of the group, copied to the head of values
+ArrayXd const& RewardManager::gather(ArrayXd const& credits, Indices const group){
+	if (values.size() < credits.size())
+		values.resize(credits.size());
+	for (int j = 0; j < group.size(); j++)
+		values(j) = credits(group[j]);
+	return values;
 }
 
-ArrayXd RewardManager::extreme(std::vector<std::vector<double>>const& credits) const {
-	return ArrayXd::NullaryExpr(K, [credits](Eigen::Index const i){
-			return credits[i].empty() ? 0. : ArrayXd::Map(credits[i].data(), credits[i].size()).maxCoeff();
-		});
+void RewardManager::average(ArrayXd const& credits, Buckets const& groups, ArrayXd& reward){
+	reward.resize(K);
+	for (int k = 0; k < K; k++){
+		int const n = groups[k].size();
+		reward(k) = n == 0 ? 0. : gather(credits, groups[k]).head(n).mean();
+	}
+}
+
+void RewardManager::extreme(ArrayXd const& credits, Buckets const& groups, ArrayXd& reward) const {
+	reward.resize(K);
+	for (int k = 0; k < K; k++){
+		reward(k) = 0.; // The credits of a group are positive
+		for (int const i : groups[k])
+			reward(k) = std::max(reward(k), credits(i));
+	}
 }
 
-ArrayXd RewardManager::normalized(ArrayXd const& x) const {
+void RewardManager::normalize(ArrayXd& x) const {
 	double const max = x.maxCoeff();
-	return max > 0. ? x/max : x;
+	if (max > 0.)
+		x /= max;
 }
 
-ArrayXd RewardManager::ranks(ArrayXd const& x) const{
-	ArrayXi ranks = ArrayXi::NullaryExpr(x.size(), [](Eigen::Index const i){return i;});
-	std::sort(ranks.begin(), ranks.end(), [x](int const i, int const j){
+ArrayXd const& RewardManager::ranks(ArrayXd const& x){
+	order.resize(x.size());
+	scores.resize(x.size());
+	for (int i = 0; i < order.size(); i++)
+		order(i) = i;
+	std::sort(order.begin(), order.end(), [&x](int const i, int const j){
 		return x[i] < x[j];
 	});
 
 	int cRank = 0;
-	ArrayXd score(ranks.size());
-	for (int i = 0; i < ranks.size(); i++){
-		if (i > 0 ? x[ranks[i]] > x[ranks[i-1]] : x[ranks[i]] > 0.)
+	for (int i = 0; i < order.size(); i++){
+		if (i > 0 ? x[order[i]] > x[order[i-1]] : x[order[i]] > 0.)
 			cRank++;
-		score[ranks[i]] = cRank;
+		scores[order[i]] = cRank;
 	}
 
-	return score;
+	return scores;
 }
 
-ArrayXd AverageNormalizedReward::getReward(ArrayXd const& improvements, 
-		ArrayXi const& assignment) const {
-	return normalized(average(group(improvements, assignment)));
+void AverageNormalizedReward::getReward(ArrayXd const& improvements, ArrayXi const& assignment, ArrayXd& reward){
+	average(improvements, group(improvements, assignment), reward);
+	normalize(reward);
 }
 
-ArrayXd ExtremeNormalizedReward::getReward(ArrayXd const& improvements, 
-		ArrayXi const& assignment) const {
-	return normalized(extreme(group(improvements, assignment)));
+void ExtremeNormalizedReward::getReward(ArrayXd const& improvements, ArrayXi const& assignment, ArrayXd& reward){
+	extreme(improvements, group(improvements, assignment), reward);
+	normalize(reward);
 }
 
-ArrayXd ExtremeReward::getReward(ArrayXd const& improvements, 
-		ArrayXi const& assignment) const {
-	return extreme(group(improvements, assignment));
+void ExtremeReward::getReward(ArrayXd const& improvements, ArrayXi const& assignment, ArrayXd& reward){
+	extreme(improvements, group(improvements, assignment), reward);
 }
 
-ArrayXd AverageReward::getReward(ArrayXd const& improvements, 
-		ArrayXi const& assignment) const {
-	return average(group(improvements, assignment));
+void AverageReward::getReward(ArrayXd const& improvements, ArrayXi const& assignment, ArrayXd& reward){
+	average(improvements, group(improvements, assignment), reward);
 }
 
-ArrayXd AverageRankReward::getReward(ArrayXd const& improvements, ArrayXi const& assignment) const{
-	return average(group(ranks(improvements), assignment));
+void AverageRankReward::getReward(ArrayXd const& improvements, ArrayXi const& assignment, ArrayXd& reward){
+	ArrayXd const& r = ranks(improvements);
+	average(r, group(r, assignment), reward);
 }
 
-ArrayXd ExtremeRankReward::getReward(ArrayXd const& improvements, ArrayXi const& assignment) const{
-	return extreme(group(ranks(improvements), assignment));
+void ExtremeRankReward::getReward(ArrayXd const& improvements, ArrayXi const& assignment, ArrayXd& reward){
+	ArrayXd const& r = ranks(improvements);
+	extreme(r, group(r, assignment), reward);
 }
@@ -1,29 +1,258 @@
 #include "rng.h"
-#include <random>
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+#include "checkpoint.h"
+
+std::function<RandomEngine* (uint64_t const)> RandomEngine::create(std::string const id){
+#define ALIAS(X, Y) if (id == X) return [](uint64_t const seed){return new Y(seed);};
+	ALIAS("MT", MersenneTwisterEngine)
+	ALIAS("XO", Xoshiro256Engine)
+	ALIAS("PH", PhiloxEngine)
+	throw std::invalid_argument("no such RandomEngine: " + id);
+}
+
+MersenneTwisterEngine::MersenneTwisterEngine(uint64_t const seed): mt(seed){}
+
+void MersenneTwisterEngine::fill(uint64_t* const words, int const n){
+	for (int i = 0; i < n; i++)
+		words[i] = mt();
+}
+
+void MersenneTwisterEngine::save(Checkpoint& checkpoint) const{
+	std::ostringstream state;
+	state << mt;
+	checkpoint.write(state.str());
+}
+
+void MersenneTwisterEngine::restore(Checkpoint& checkpoint){
+	std::string state;
+	checkpoint.read(state);
+	std::istringstream(state) >> mt;
+}
+
+static uint64_t splitMix64(uint64_t& x){
+	uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+	return z ^ (z >> 31);
+}
+
+static inline uint64_t rotl(uint64_t const x, int const k){
+	return (x << k) | (x >> (64 - k));
+}
+
+Xoshiro256Engine::Xoshiro256Engine(uint64_t seed){
+	for (uint64_t& w : s) // The state must not be all zero, SplitMix64 output never is for four consecutive words
+		w = splitMix64(seed);
+}
+
+void Xoshiro256Engine::fill(uint64_t* const words, int const n){
+	uint64_t s0 = s[0], s1 = s[1], s2 = s[2], s3 = s[3];
+	for (int i = 0; i < n; i++){
+		words[i] = rotl(s0 + s3, 23) + s0;
+		uint64_t const t = s1 << 17;
+		s2 ^= s0;
+		s3 ^= s1;
+		s1 ^= s2;
+		s0 ^= s3;
+		s2 ^= t;
+		s3 = rotl(s3, 45);
+	}
+	s[0] = s0; s[1] = s1; s[2] = s2; s[3] = s3;
+}
+
+void Xoshiro256Engine::save(Checkpoint& checkpoint) const{
+	checkpoint.write(s, sizeof(s));
+}
+
+void Xoshiro256Engine::restore(Checkpoint& checkpoint){
+	checkpoint.read(s, sizeof(s));
+}
+
+PhiloxEngine::PhiloxEngine(uint64_t const seed)
+	:counter{0, 0, 0, 0}, key{uint32_t(seed), uint32_t(seed >> 32)}{}
+
+// Each block encrypts the 128-bit counter under the key, giving two words
+void PhiloxEngine::fill(uint64_t* const words, int const n){
+	for (int i = 0; i < n; i += 2){
+		uint32_t c[4] = {counter[0], counter[1], counter[2], counter[3]};
+		uint32_t k[2] = {key[0], key[1]};
+		for (int round = 0; round < 10; round++){
+			uint64_t const p0 = uint64_t(0xD2511F53u) * c[0], p1 = uint64_t(0xCD9E8D57u) * c[2];
+			uint32_t const next[4] = {
+				uint32_t(p1 >> 32) ^ c[1] ^ k[0], uint32_t(p1), 
+				uint32_t(p0 >> 32) ^ c[3] ^ k[1], uint32_t(p0)};
+			std::copy(next, next+4, c);
+			k[0] += 0x9E3779B9u;
+			k[1] += 0xBB67AE85u;
+		}
+		words[i] = (uint64_t(c[1]) << 32) | c[0];
+		if (i+1 < n)
+			words[i+1] = (uint64_t(c[3]) << 32) | c[2];
+
+		for (int j = 0; j < 4 && ++counter[j] == 0; j++); // 128-bit increment
+	}
+}
+
+void PhiloxEngine::save(Checkpoint& checkpoint) const{
+	checkpoint.write(counter, sizeof(counter));
+	checkpoint.write(key, sizeof(key));
+}
+
+void PhiloxEngine::restore(Checkpoint& checkpoint){
+	checkpoint.read(counter, sizeof(counter));
+	checkpoint.read(key, sizeof(key));
+}
+
+RNG::RNG()
+	:engineID("XO"), engine(nullptr), buffer(256){
+	seed();
+}
+
+RNG::~RNG(){
+	delete engine;
+}
+
+void RNG::setEngine(std::string const id){
+	RandomEngine* const e = RandomEngine::create(id)(engineSeed);
+	delete engine;
+	engine = e;
+	engineID = id;
+	position = buffer.size(); // Discard the words of the previous stream
+}
+
+std::string const& RNG::getEngine() const{
+	return engineID;
+}
+
+void RNG::seed(uint64_t const s){ 
+	engineSeed = s;
+	setEngine(engineID);
+}
+
+void RNG::seed(){
+	std::random_device dev;
+	seed((uint64_t(dev()) << 32) | dev());
+}
+
+void RNG::save(Checkpoint& checkpoint) const{
+	checkpoint.write(engineID);
+	checkpoint.write(engineSeed);
+	engine->save(checkpoint);
+	checkpoint.write(buffer.data(), buffer.size() * sizeof(uint64_t));
+	checkpoint.write(position);
+}
+
+void RNG::restore(Checkpoint& checkpoint){
+	std::string id;
+	checkpoint.read(id);
+	checkpoint.read(engineSeed);
+	setEngine(id);
+	engine->restore(checkpoint);
+	checkpoint.read(buffer.data(), buffer.size() * sizeof(uint64_t));
+	checkpoint.read(position);
+}
+
+static double const twoPowMinus53 = 1. / 9007199254740992.;
+
+double RNG::uniform(){
+	return (word() >> 11) * twoPowMinus53;
+}
+
+double RNG::uniformPositive(){
+	return ((word() >> 11) + 1) * twoPowMinus53;
+}
 
 double RNG::randDouble(double const start, double const end){
-	std::uniform_real_distribution<double> dist(start, end);
-	return dist(rng);
+	return start + (end - start) * uniform();
 }
 
+// Lemire's nearly divisionless method, unbiased
 int RNG::randInt(int const start, int const end){
-	std::uniform_int_distribution<int> dist(start, end);
-	return dist(rng);
+	uint32_t const range = uint32_t(end - start) + 1;
+	uint64_t m = (word() >> 32) * range;
+	if (uint32_t(m) < range){
+		uint32_t const threshold = -range % range;
+		while (uint32_t(m) < threshold)
+			m = (word() >> 32) * range;
+	}
+	return start + int(m >> 32);
 }
 
+// Box-Muller
 double RNG::normalDouble(double const mean, double const stdDev){
-	std::normal_distribution<double> N(mean, stdDev);
-	return N(rng);
+	double const r = std::sqrt(-2. * std::log(uniformPositive()));
+	return mean + stdDev * r * std::cos(2. * M_PI * uniform());
 }
 
 double RNG::cauchyDouble(double const a, double const b){
-	std::cauchy_distribution<double> C(a,b);
-	return C(rng);
+	return a + b * std::tan(M_PI * (uniform() - .5));
 }
 
+int RNG::available(int const n){
+	if (position == buffer.size()){
+		engine->fill(buffer.data(), buffer.size());
+		position = 0;
+	}
+	return std::min(n, int(buffer.size() - position));
+}
 
-void RNG::seed(double const s){ 
-	rng.seed(s);
+// The top 53 bits of a word, as a double: uniform() before its scaling
+struct HighBits{
+	double operator()(uint64_t const w) const {return double(w >> 11);}
 };
+typedef Eigen::Map<Eigen::Array<uint64_t, Eigen::Dynamic, 1> const> Words;
+
+// Whole runs of the buffer at a time: the words are converted into x, which is then scaled in place
+void RNG::fillUniform(Eigen::Ref<Eigen::ArrayXXd> x, double const start, double const end){
+	for (int c = 0; c < x.cols(); c++){
+		for (int r = 0; r < x.rows();){
+			int const n = available(x.rows() - r);
+			auto block = x.col(c).segment(r, n);
+			block = Words(&buffer[position], n).unaryExpr(HighBits());
+			block = start + (end - start) * (block * twoPowMinus53);
+			position += n;
+			r += n;
+		}
+	}
+}
+
+// Box-Muller in pairs: both the cosine and the sine branch are used. The first word of a pair gives the
+// radius, the second the angle, converted a run of the buffer at a time as by fillUniform()
+void RNG::fillNormal(Eigen::Ref<Eigen::ArrayXXd> x, double const mean, double const stdDev){
+	for (int c = 0; c < x.cols(); c++){
+		int r = 0;
+		while (r+1 < x.rows()){
+			int const n = available(x.rows() - r) & ~1;
+			if (n == 0){ // A pair across a refill of the buffer
+				double const radius = stdDev * std::sqrt(-2. * std::log(uniformPositive()));
+				double const angle = 2. * M_PI * uniform();
+				x(r,c) = mean + radius * std::cos(angle);
+				x(r+1,c) = mean + radius * std::sin(angle);
+				r += 2;
+				continue;
+			}
+			auto block = x.col(c).segment(r, n);
+			block = Words(&buffer[position], n).unaryExpr(HighBits());
+			for (int j = 0; j < n; j += 2){
+				double const radius = stdDev * std::sqrt(-2. * std::log((block(j) + 1.) * twoPowMinus53));
+				double const angle = 2. * M_PI * (block(j+1) * twoPowMinus53);
+				block(j) = mean + radius * std::cos(angle);
+				block(j+1) = mean + radius * std::sin(angle);
+			}
+			position += n;
+			r += n;
+		}
+		if (r < x.rows())
+			x(r,c) = normalDouble(mean, stdDev);
+	}
+}
+
+void RNG::fillCauchy(Eigen::Ref<Eigen::ArrayXXd> x, double const a, double const b){
+	fillUniform(x, -.5, .5);
+	x = a + b * (M_PI * x).tan();
+}
 
-RNG rng; //Global random number generator
+thread_local RNG rng; //Global random number generator
@@ -11,11 +11,13 @@
 #include "mutationmanager.h"
 #include "crossovermanager.h"
 #include "parameteradaptationmanager.h"
+#include "population.h"
+#include "checkpoint.h"
 
 std::function<StrategyAdaptationManager* (StrategyAdaptationConfiguration const, ConstraintHandler *const, 
-		std::vector<Solution*>const&)> StrategyAdaptationManager::create(std::string const id){
+		Population const&)> StrategyAdaptationManager::create(std::string const id){
 #define ALIAS(X, Y) if (id == X) return [](StrategyAdaptationConfiguration const s, ConstraintHandler *const c, \
-	std::vector<Solution*>const& p){return new Y(s,c,p);};
+	Population const& p){return new Y(s,c,p);};
 	ALIAS("A", AdaptiveStrategyManager)
 	ALIAS("R", RandomStrategyManager)
 	ALIAS("C", ConstantStrategyManager)
@@ -23,10 +25,12 @@ std::function<StrategyAdaptationManager* (StrategyAdaptationConfiguration const,
 }
 
 StrategyAdaptationManager::StrategyAdaptationManager(StrategyAdaptationConfiguration const config, 
-		ConstraintHandler * const ch, std::vector<Solution*>const& population)
+		ConstraintHandler * const ch, Population const& population)
 	: K(config.crossover.size() * config.mutation.size()), config(config), popSize(population.size()),  
-	D(population[0]->D), parameterAdaptationManager(ParameterAdaptationManager::create(config.param)(popSize,K)), 
-	previousStrategies(popSize){
+	D(population.dimension()), parameterAdaptationManager(ParameterAdaptationManager::create(config.param)(popSize,K)), 
+	previousStrategies(ArrayXi::Zero(popSize)), targetFs(popSize), targetCrs(popSize), windowDeltas(popSize), 
+	windowPreviousDistances(popSize), windowCurrentDistances(popSize), windowFs(popSize), windowCrs(popSize), 
+	windowStrategies(popSize), windowSize(0){
 
 	for (std::string const& m : config.mutation)
 		mutationManagers.push_back(MutationManager::create(m)(ch));
@@ -36,29 +40,60 @@ StrategyAdaptationManager::StrategyAdaptationManager(StrategyAdaptationConfigura
 		for (auto const& c : crossoverManagers)
 			configurations.push_back({m,c});
 
-	for (std::string const& m : config.mutation)
-		for (std::string const& c : config.crossover)
+	for (std::string const& m : config.mutation){
+		for (std::string const& c : config.crossover){
 			configurationIDs.push_back(m + "_" + c);
+			trialKernels.push_back(getTrialKernel(m, c));
+		}
+	}
 }
 
 std::vector<std::string> StrategyAdaptationManager::getConfigurationIDs() const{
 	return configurationIDs;
 }
 
-void StrategyAdaptationManager::assign(std::map<MutationManager*, std::vector<int>>& mutation, 
-		std::map<CrossoverManager*, std::vector<int>>& crossover, std::vector<int> const& assignment){
-	mutation.clear(); 
-	crossover.clear();
-	for (int i = 0; i < popSize; i++){
-		MutationManager* const m = std::get<0>(configurations[assignment[i]]);
-		CrossoverManager* const c = std::get<1>(configurations[assignment[i]]);
-		if (!mutation.count(m)) mutation[m] = {};
-		if (!crossover.count(c)) crossover[c] = {};
-		mutation[m].push_back(i); 
-		crossover[c].push_back(i);
+// Groups the individuals by the configuration they were assigned
+void StrategyAdaptationManager::assign(Buckets& assignment, ArrayXi const& strategies) const{
+	assignment.build(K, strategies, popSize);
+}
+
+int StrategyAdaptationManager::next(Population const& population, ArrayXd const& mean, int const i, 
+		double& F, double& Cr){
+	if (previousFitness.size() != popSize){
+		previousFitness = population.getFitness();
+		computeDistances(population, mean, previousDistances);
+	}
+	previousFitness(i) = population.getFitness(i);
+	previousDistances(i) = distance(population.X(i), mean);
+	previousStrategies[i] = sampleStrategy();
+	parameterAdaptationManager->nextParameters(previousStrategies[i], F, Cr);
+	targetFs(i) = F;
+	targetCrs(i) = Cr;
+	return previousStrategies[i];
+}
+
+void StrategyAdaptationManager::update(Population const& trials, ArrayXd const& mean, int const i){
+	int const w = windowSize++;
+	windowDeltas(w) = previousFitness(i) - trials.getFitness(i);
+	windowPreviousDistances(w) = previousDistances(i);
+	windowCurrentDistances(w) = distance(trials.X(i), mean);
+	windowStrategies(w) = previousStrategies[i];
+	windowFs(w) = targetFs(i);
+	windowCrs(w) = targetCrs(i);
+	if (windowSize == popSize){
+		adapt(windowDeltas, windowPreviousDistances, windowCurrentDistances, windowStrategies, windowFs, windowCrs);
+		windowSize = 0;
 	}
 }
 
+void StrategyAdaptationManager::save(Checkpoint& checkpoint) const{
+	parameterAdaptationManager->save(checkpoint);
+}
+
+void StrategyAdaptationManager::restore(Checkpoint& checkpoint){
+	parameterAdaptationManager->restore(checkpoint);
+}
+
 std::vector<MutationManager*> StrategyAdaptationManager::getMutationManagers() const{
 	return mutationManagers;
 }
@@ -67,14 +102,21 @@ std::vector<CrossoverManager*> StrategyAdaptationManager::getCrossoverManagers()
 	return crossoverManagers;
 }
 
-ArrayXi StrategyAdaptationManager::getLastActivations() const{
-	ArrayXi activations = ArrayXi::Zero(K);
-	for (int i : previousStrategies)
-		activations(i)++;
-	return activations;
+std::vector<std::tuple<MutationManager*, CrossoverManager*>> const& 
+StrategyAdaptationManager::getConfigurations() const{
+	return configurations;
 }
 
-ArrayXd StrategyAdaptationManager::getDistancesToMeanPosition() const {
+std::vector<TrialKernel> const& StrategyAdaptationManager::getTrialKernels() const{
+	return trialKernels;
+}
+
+void StrategyAdaptationManager::addLastActivations(ArrayXi& activations) const{
+	for (int i = 0; i < popSize; i++)
+		activations(previousStrategies(i))++;
+}
+
+ArrayXd const& StrategyAdaptationManager::getDistancesToMeanPosition() const {
 	return previousDistances;
 }
 
@@ -87,7 +129,7 @@ StrategyAdaptationManager::~StrategyAdaptationManager(){
 }
 
 AdaptiveStrategyManager::AdaptiveStrategyManager(StrategyAdaptationConfiguration const config, 
-		ConstraintHandler*const ch, std::vector<Solution*>const& population)
+		ConstraintHandler*const ch, Population const& population)
 	: StrategyAdaptationManager(config, ch, population), 
 	creditManager(CreditManager::create(config.credit)()),
 	rewardManager(RewardManager::create(config.reward)(K)),
@@ -95,6 +137,7 @@ AdaptiveStrategyManager::AdaptiveStrategyManager(StrategyAdaptationConfiguration
 	probabilityManager(ProbabilityManager::create(config.probability)(K)), 
 	p(ArrayXd::Constant(K, 1./K)), q(ArrayXd::Constant(K, 0.)), used(K){
 	assert(configurations.size() > 1);
+	strategySampler.build(p);
 }
 
 AdaptiveStrategyManager::~AdaptiveStrategyManager(){
@@ -104,44 +147,38 @@ AdaptiveStrategyManager::~AdaptiveStrategyManager(){
 	delete probabilityManager;
 }
 
-void AdaptiveStrategyManager::next(std::vector<Solution*>const& population, std::map<MutationManager*, 
-		std::vector<int>>& mutation, std::map<CrossoverManager*, std::vector<int>>& crossover, 
+void AdaptiveStrategyManager::next(Population const& population, Buckets& assignment, 
 		ArrayXd& Fs, ArrayXd& Crs){
-	previousMean = getMean(population);
-	previousDistances = getDistances(population, previousMean);
+	computeMean(population, previousMean);
+	computeDistances(population, previousMean, previousDistances);
 
-	previousStrategies = //Roulette with replacement
-		rouletteSelect(range(K), std::vector<double>(p.begin(), p.end()), popSize, true); 
+	strategySampler.build(p); //Roulette with replacement
+	for (int i = 0; i < popSize; i++)
+		previousStrategies[i] = strategySampler.sample();
 
 	// Update used strategies
 	std::fill(used.begin(), used.end(), 0);
-	for (int i : previousStrategies) 
-		used[i] = 1;
+	for (int i = 0; i < popSize; i++)
+		used[previousStrategies(i)] = 1;
 
-	previousFitness = ArrayXd::NullaryExpr(popSize, [population](Eigen::Index const i){
-		return population[i]->getFitness();
-	});
+	previousFitness = population.getFitness();
 
-	assign(mutation, crossover, previousStrategies);
+	assign(assignment, previousStrategies);
 
-	parameterAdaptationManager->nextParameters(Fs, Crs, 
-			ArrayXi::Map(previousStrategies.data(), previousStrategies.size()));
+	parameterAdaptationManager->nextParameters(Fs, Crs, previousStrategies);
 }
 
-void AdaptiveStrategyManager::update(std::vector<Solution*>const& trials){
+void AdaptiveStrategyManager::update(Population const& trials){
 	// Fitness improvements. Deteriorations are set to 0.
-	ArrayXd const fitnessDeltas = ArrayXd::NullaryExpr(popSize, [trials, this](Eigen::Index const i){
-		return previousFitness[i] - trials[i]->getFitness();
-	});
+	fitnessDeltas = previousFitness - trials.getFitness();
 
-	ArrayXd const currentDistances = getDistances(trials, previousMean);
+	computeDistances(trials, previousMean, currentDistances);
 
-	ArrayXd const credit = creditManager->getCredit(fitnessDeltas, previousDistances, currentDistances);
+	creditManager->getCredit(fitnessDeltas, previousDistances, currentDistances, credit);
 
-	ArrayXd const r = rewardManager->getReward(
-			credit, ArrayXi::Map(previousStrategies.data(), previousStrategies.size()));
+	rewardManager->getReward(credit, previousStrategies, reward);
 
-	qualityManager->updateQuality(q, r, used);
+	qualityManager->updateQuality(q, reward, used);
 
 	if (q.maxCoeff() > 0.)
 		probabilityManager->updateProbability(p, q);
@@ -151,90 +188,135 @@ void AdaptiveStrategyManager::update(std::vector<Solution*>const& trials){
 	parameterAdaptationManager->update(credit);
 }
 
-ArrayXd StrategyAdaptationManager::getMean(std::vector<Solution*>const& population) const{
-	ArrayXXd pop(D, popSize);
-	for (int i = 0; i < popSize; i++)
-		pop.col(i) = population[i]->X();
-	return pop.rowwise().mean();
+void AdaptiveStrategyManager::save(Checkpoint& checkpoint) const{
+	StrategyAdaptationManager::save(checkpoint);
+	checkpoint.write(p);
+	checkpoint.write(q);
+	checkpoint.write(used);
+}
+
+void AdaptiveStrategyManager::restore(Checkpoint& checkpoint){
+	StrategyAdaptationManager::restore(checkpoint);
+	checkpoint.read(p);
+	checkpoint.read(q);
+	checkpoint.read(used);
+	strategySampler.build(p);
 }
 
-ArrayXd StrategyAdaptationManager::getDistances(std::vector<Solution*>const& population, // Distances w.r.t. mean
-		ArrayXd const& mean) const {
-	return ArrayXd::NullaryExpr(popSize, [population, mean](Eigen::Index const i){
-			return distance(population[i]->X(), mean);
-	}); 
+int AdaptiveStrategyManager::sampleStrategy(){
+	return strategySampler.sample();
+}
+
+void AdaptiveStrategyManager::adapt(ArrayXd const& fitnessDeltas, ArrayXd const& previousDistances, 
+		ArrayXd const& currentDistances, ArrayXi const& strategies, ArrayXd const& Fs, ArrayXd const& Crs){
+	creditManager->getCredit(fitnessDeltas, previousDistances, currentDistances, credit);
+
+	rewardManager->getReward(credit, strategies, reward);
+
+	used.setZero();
+	for (int i = 0; i < strategies.size(); i++)
+		used[strategies(i)] = 1;
+	qualityManager->updateQuality(q, reward, used);
+
+	if (q.maxCoeff() > 0.)
+		probabilityManager->updateProbability(p, q);
+	else
+		p = 1./K;
+	strategySampler.build(p);
+
+	parameterAdaptationManager->update(credit, Fs, Crs, strategies);
+}
+
+void StrategyAdaptationManager::computeMean(Population const& population, ArrayXd& mean) const{
+	mean = population.X().rowwise().mean();
+}
+
+void StrategyAdaptationManager::computeDistances(Population const& population, // Distances w.r.t. mean
+		ArrayXd const& mean, ArrayXd& distances) const {
+	distances.resize(popSize);
+	for (int i = 0; i < popSize; i++)
+		distances(i) = distance(population.X(i), mean);
 }
 
 RandomStrategyManager::RandomStrategyManager(StrategyAdaptationConfiguration const config, 
-		ConstraintHandler*const ch, std::vector<Solution*>const& population)
+		ConstraintHandler*const ch, Population const& population)
 	: StrategyAdaptationManager(config, ch, population){
 }
 
-void RandomStrategyManager::next(std::vector<Solution*>const& population, std::map<MutationManager*, 
-		std::vector<int>>& mutation, std::map<CrossoverManager*, std::vector<int>>& crossover, 
+void RandomStrategyManager::next(Population const& population, Buckets& assignment, 
 		ArrayXd& Fs, ArrayXd& Crs){
-	previousMean = getMean(population);
-	previousDistances = getDistances(population, previousMean);
+	computeMean(population, previousMean);
+	computeDistances(population, previousMean, previousDistances);
 
 	for (int i = 0; i < popSize; i++)
 		previousStrategies[i] = rng.randInt(0, K-1); // uniformly random allocation
 
-	previousFitness = ArrayXd::NullaryExpr(popSize, [population](Eigen::Index const i){
-		return population[i]->getFitness();
-	});
+	previousFitness = population.getFitness();
 
-	assign(mutation, crossover, previousStrategies);
+	assign(assignment, previousStrategies);
 
-	parameterAdaptationManager->nextParameters(Fs, Crs, 
-			ArrayXi::Map(previousStrategies.data(), previousStrategies.size()));
+	parameterAdaptationManager->nextParameters(Fs, Crs, previousStrategies);
 }
 
-void RandomStrategyManager::update(std::vector<Solution*>const& trials){
+void RandomStrategyManager::update(Population const& trials){
 	// Fitness improvements. Deteriorations are set to 0.
-	ArrayXd const credit = ArrayXd::NullaryExpr(popSize, [trials, this](Eigen::Index const i){
-		return previousFitness[i] - trials[i]->getFitness();
-	}).max(0);
+	credit = (previousFitness - trials.getFitness()).max(0);
 
 	parameterAdaptationManager->update(credit);
 }
 
+int RandomStrategyManager::sampleStrategy(){
+	return rng.randInt(0, K-1);
+}
+
+void RandomStrategyManager::adapt(ArrayXd const& fitnessDeltas, ArrayXd const& /*previousDistances*/, 
+		ArrayXd const& /*currentDistances*/, ArrayXi const& strategies, ArrayXd const& Fs, ArrayXd const& Crs){
+	credit = fitnessDeltas.max(0);
+	parameterAdaptationManager->update(credit, Fs, Crs, strategies);
+}
+
 ConstantStrategyManager::ConstantStrategyManager(StrategyAdaptationConfiguration const config, 
-		ConstraintHandler*const ch, std::vector<Solution*>const& population)
+		ConstraintHandler*const ch, Population const& population)
 	: StrategyAdaptationManager(config, ch, population), 
 	creditManager(CreditManager::create(config.credit)()){
 	assert(config.mutation.size() == 1 && config.crossover.size() == 1);
-	std::fill(previousStrategies.begin(), previousStrategies.end(), 0);
+	previousStrategies.setZero();
 }
 
 ConstantStrategyManager::~ConstantStrategyManager(){
 	delete creditManager;
 }
 
-void ConstantStrategyManager::next(std::vector<Solution*>const& population, std::map<MutationManager*, 
-		std::vector<int>>& mutation, std::map<CrossoverManager*, std::vector<int>>& crossover, 
+void ConstantStrategyManager::next(Population const& population, Buckets& assignment, 
 		ArrayXd& Fs, ArrayXd& Crs){
-	previousMean = getMean(population);
-	previousDistances = getDistances(population, previousMean);
+	computeMean(population, previousMean);
+	computeDistances(population, previousMean, previousDistances);
 
 	// previousStrategies is not updated because it is constant 0
-	previousFitness = ArrayXd::NullaryExpr(popSize, [population](Eigen::Index const i){
-		return population[i]->getFitness();
-	});
+	previousFitness = population.getFitness();
 
-	assign(mutation, crossover, previousStrategies);
+	assign(assignment, previousStrategies);
 
-	parameterAdaptationManager->nextParameters(Fs, Crs, 
-			ArrayXi::Map(previousStrategies.data(), previousStrategies.size()));
+	parameterAdaptationManager->nextParameters(Fs, Crs, previousStrategies);
 }
 
-void ConstantStrategyManager::update(std::vector<Solution*>const& trials){
-	ArrayXd const fitnessDeltas = ArrayXd::NullaryExpr(popSize, [trials, this](Eigen::Index const i){
-		return previousFitness[i] - trials[i]->getFitness();
-	});
+void ConstantStrategyManager::update(Population const& trials){
+	fitnessDeltas = previousFitness - trials.getFitness();
 
-	ArrayXd const currentDistances = getDistances(trials, previousMean);
+	computeDistances(trials, previousMean, currentDistances);
 	
-	ArrayXd const credit = creditManager->getCredit(fitnessDeltas, previousDistances, currentDistances);
+	creditManager->getCredit(fitnessDeltas, previousDistances, currentDistances, credit);
 
 	parameterAdaptationManager->update(credit);
 }
+
+int ConstantStrategyManager::sampleStrategy(){
+	return 0;
+}
+
+void ConstantStrategyManager::adapt(ArrayXd const& fitnessDeltas, ArrayXd const& previousDistances, 
+		ArrayXd const& currentDistances, ArrayXi const& strategies, ArrayXd const& Fs, ArrayXd const& Crs){
+	creditManager->getCredit(fitnessDeltas, previousDistances, currentDistances, credit);
+
+	parameterAdaptationManager->update(credit, Fs, Crs, strategies);
+}
@@ -0,0 +1,120 @@
+#include "threadpool.h"
+
+ThreadPool::ThreadPool(int const size)
+	:n(0), next(0), busy(0), round(0), stopping(false){
+	for (int thread = 1; thread < size; thread++)
+		workers.emplace_back(&ThreadPool::work, this, thread);
+}
+
+ThreadPool::~ThreadPool(){
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	started.notify_all();
+	for (std::thread& worker : workers)
+		worker.join();
+}
+
+int ThreadPool::size() const {
+	return workers.size() + 1;
+}
+
+void ThreadPool::claim(int const thread){
+	for (int i = next++; i < n; i = next++)
+		task(thread, i);
+}
+
+void ThreadPool::work(int const thread){
+	unsigned int seen = 0;
+	while (true){
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			started.wait(lock, [this, seen](){return stopping || round != seen;});
+			if (stopping)
+				return;
+			seen = round;
+		}
+
+		claim(thread);
+
+		std::lock_guard<std::mutex> lock(mutex);
+		if (--busy == 0)
+			finished.notify_one();
+	}
+}
+
+void ThreadPool::run(int const n, std::function<void(int, int)> const& task){
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		this->task = task;
+		this->n = n;
+		next = 0;
+		busy = workers.size();
+		round++;
+	}
+	started.notify_all();
+
+	claim(0);
+
+	std::unique_lock<std::mutex> lock(mutex);
+	finished.wait(lock, [this](){return busy == 0;});
+}
+
+AsyncExecutor::AsyncExecutor(int const size, std::function<void(int, int)> const& task)
+	:task(task), stopping(false){
+	for (int thread = 0; thread < size; thread++)
+		workers.emplace_back(&AsyncExecutor::work, this, thread);
+}
+
+AsyncExecutor::~AsyncExecutor(){
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	submitted.notify_all();
+	for (std::thread& worker : workers)
+		worker.join();
+}
+
+int AsyncExecutor::size() const {
+	return workers.size();
+}
+
+void AsyncExecutor::work(int const thread){
+	while (true){
+		int i;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			submitted.wait(lock, [this](){return stopping || !pending.empty();});
+			if (stopping)
+				return;
+			i = pending.front();
+			pending.pop_front();
+		}
+
+		task(thread, i);
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			done.push_back(i);
+		}
+		finished.notify_one();
+	}
+}
+
+void AsyncExecutor::submit(int const i){
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		pending.push_back(i);
+	}
+	submitted.notify_one();
+}
+
+int AsyncExecutor::wait(){
+	std::unique_lock<std::mutex> lock(mutex);
+	finished.wait(lock, [this](){return !done.empty();});
+	int const i = done.front();
+	done.pop_front();
+	return i;
+}
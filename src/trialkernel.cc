@@ -0,0 +1,52 @@
+#include <stdexcept>
+#include "trialkernel.h"
+#include "mutationmanager.h"
+#include "crossovermanager.h"
+
+template <class M, class C>
+void trialKernel(MutationManager& mutation, CrossoverManager const& crossover, Population const& genomes, 
+		Indices const indices, ArrayXd const& Fs, ArrayXd const& Crs, ArrayXXd& donors, Population& trials){
+	for (int const i : indices)
+		mutation.mutate<M>(genomes, i, Fs[i], donors.col(i));
+	static_cast<C const&>(crossover).C::crossover(genomes.X(), donors, Crs, indices, trials);
+}
+
+// Binomial crossover is fused with the mutation: each donor is crossed over into its trial as soon as it is
+// generated, in one pass while it is in cache, instead of going through the donor population
+template <class M>
+void binomialTrialKernel(MutationManager& mutation, CrossoverManager const& crossover, Population const& genomes, 
+		Indices const indices, ArrayXd const& Fs, ArrayXd const& Crs, ArrayXXd& /*donors*/, Population& trials){
+	BinomialCrossoverManager const& binomial = static_cast<BinomialCrossoverManager const&>(crossover);
+	Column donor = binomial.getDonor(genomes.dimension());
+	binomial.draw(genomes.X(), indices.size());
+	for (int j = 0; j < indices.size(); j++){
+		int const i = indices[j];
+		mutation.mutate<M>(genomes, i, Fs[i], donor);
+		binomial.cross(j, genomes.X(i), donor, Crs(i), trials.modifyX(i));
+	}
+}
+
+TrialKernel getTrialKernel(std::string const mutation, std::string const crossover){
+	std::string const id = mutation + "_" + crossover;
+#define ALIAS(X, Y, Z) if (id == X) return &trialKernel<Y, Z>;
+#define CROSSOVERS(X, Y) \
+	if (id == X "_B") return &binomialTrialKernel<Y>; \
+	ALIAS(X "_E", Y, ExponentialCrossoverManager) \
+	ALIAS(X "_A", Y, ArithmeticCrossoverManager)
+	CROSSOVERS("RA1", Rand1MutationManager)
+	CROSSOVERS("TB1", TTB1MutationManager)
+	CROSSOVERS("TB2", TTB2MutationManager)
+	CROSSOVERS("TR1", TTR1MutationManager)
+	CROSSOVERS("TP1", TTPB1MutationManager)
+	CROSSOVERS("BE1", Best1MutationManager)
+	CROSSOVERS("BE2", Best2MutationManager)
+	CROSSOVERS("RA2", Rand2MutationManager)
+	CROSSOVERS("R2D", Rand2DirMutationManager)
+	CROSSOVERS("NSD", NSDEMutationManager)
+	CROSSOVERS("TRI", TrigonometricMutationManager)
+	CROSSOVERS("TO1", TwoOpt1MutationManager)
+	CROSSOVERS("TO2", TwoOpt2MutationManager)
+	CROSSOVERS("PRX", ProximityMutationManager)
+	CROSSOVERS("RAN", RankingMutationManager)
+	throw std::invalid_argument("no such configuration: " + id);
+}
@@ -1,11 +1,7 @@
 #include "util.h"
 #include "rng.h"
 
-double distance(Solution const*const s1, Solution const*const s2) {
-	return distance(s1->X(), s2->X());
-}
-
-double distance(ArrayXd const& s1, ArrayXd const& s2){
+double distance(ConstColumn const& s1, ConstColumn const& s2){
 	return (s1 - s2).matrix().norm();
 }
 
@@ -15,17 +11,71 @@ std::vector<int> range(int const size){
 	return r;
 }
 
-Solution* getBest(std::vector<Solution*>const& genomes){
-	return *std::min_element(genomes.begin(), genomes.end(), 
-			[](Solution const* const a, Solution const* const b){return *a < *b;});
+int getBest(Population const& genomes){
+	ArrayXd const& f = genomes.getFitness();
+	return std::min_element(f.data(), f.data() + f.size()) - f.data();
+}
+
+int getWorst(Population const& genomes){
+	ArrayXd const& f = genomes.getFitness();
+	return std::max_element(f.data(), f.data() + f.size()) - f.data();
+}
+
+std::vector<int> sortOnFitness(Population const& genomes){
+	std::vector<int> sorted;
+	sortOnFitness(genomes, sorted);
+	return sorted;
+}
+
+void sortOnFitness(Population const& genomes, std::vector<int>& sorted){
+	ArrayXd const& f = genomes.getFitness();
+	sorted.resize(genomes.size());
+	std::iota(sorted.begin(), sorted.end(), 0);
+	std::sort(sorted.begin(), sorted.end(), [&f](int const a, int const b){return f(a) < f(b);});
+}
+
+int AliasTable::sample() const {
+	int const i = rng.randInt(0, prob.size()-1);
+	return rng.randDouble(0,1) < prob[i] ? i : alias[i];
+}
+
+double FenwickSampler::total() const {
+	double sum = 0.;
+	for (int i = n; i > 0; i -= i & -i)
+		sum += tree[i];
+	return sum;
+}
+
+// Index of the first element whose cumulative weight reaches value
+int FenwickSampler::find(double const value) const {
+	int pos = 0;
+	double remainder = value;
+	for (int step = top; step > 0; step /= 2){
+		if (pos + step <= n && tree[pos + step] < remainder){
+			pos += step;
+			remainder -= tree[pos];
+		}
+	}
+	return pos;
+}
+
+int FenwickSampler::sample() const {
+	double const value = std::max(rng.randDouble(0., total()), std::numeric_limits<double>::min());
+	int i = std::min(find(value), n-1);
+	while (i > 0 && weights[i] <= 0.) // Only reachable through rounding errors
+		i--;
+	return i;
 }
 
-Solution* getWorst(std::vector<Solution*>const& genomes){
-	return *std::max_element(genomes.begin(), genomes.end(), 
-			[](Solution const * const a, Solution const * const b){return *a < *b;});
+void FenwickSampler::remove(int const i){
+	double const w = weights[i];
+	weights[i] = 0.;
+	for (int j = i+1; j <= n; j += j & -j)
+		tree[j] -= w;
 }
 
-std::vector<Solution*> sortOnFitness(std::vector<Solution*> genomes){
-	std::sort(genomes.begin(), genomes.end(), [](Solution* a, Solution* b){return *a < *b;});
-	return genomes;
+int FenwickSampler::next(){
+	int const i = sample();
+	remove(i);
+	return i;
 }